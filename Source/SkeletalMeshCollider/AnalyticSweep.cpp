@@ -0,0 +1,363 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AnalyticSweep.h"
+
+#include "Math/VectorRegister.h"
+
+namespace
+{
+	const float SweepInfinity = 1e30f;
+	const float AxisLengthSquaredEpsilon = 1e-8f;
+	const float ParallelEpsilon = 1e-6f;
+
+	/** Three component vectors, one per SIMD lane. */
+	struct FVector4Lanes
+	{
+		VectorRegister X;
+		VectorRegister Y;
+		VectorRegister Z;
+	};
+
+	template <typename GetVectorType>
+	FORCEINLINE FVector4Lanes GatherLanes(GetVectorType GetVector)
+	{
+		const FVector V0 = GetVector(0), V1 = GetVector(1), V2 = GetVector(2), V3 = GetVector(3);
+		return FVector4Lanes{
+			MakeVectorRegister(V0.X, V1.X, V2.X, V3.X),
+			MakeVectorRegister(V0.Y, V1.Y, V2.Y, V3.Y),
+			MakeVectorRegister(V0.Z, V1.Z, V2.Z, V3.Z) };
+	}
+
+	FORCEINLINE VectorRegister Dot(const FVector4Lanes& A, const FVector4Lanes& B)
+	{
+		return VectorMultiplyAdd(A.X, B.X, VectorMultiplyAdd(A.Y, B.Y, VectorMultiply(A.Z, B.Z)));
+	}
+
+	FORCEINLINE FVector4Lanes Cross(const FVector4Lanes& A, const FVector4Lanes& B)
+	{
+		return FVector4Lanes{
+			VectorSubtract(VectorMultiply(A.Y, B.Z), VectorMultiply(A.Z, B.Y)),
+			VectorSubtract(VectorMultiply(A.Z, B.X), VectorMultiply(A.X, B.Z)),
+			VectorSubtract(VectorMultiply(A.X, B.Y), VectorMultiply(A.Y, B.X)) };
+	}
+
+	/** Projection radius of a box with the given axes and half extents onto Axis. */
+	FORCEINLINE VectorRegister ProjectedRadius(const FVector4Lanes BoxAxes[3], const VectorRegister BoxHalfExtents[3], const FVector4Lanes& Axis)
+	{
+		VectorRegister Radius = VectorMultiply(VectorAbs(Dot(BoxAxes[0], Axis)), BoxHalfExtents[0]);
+		Radius = VectorMultiplyAdd(VectorAbs(Dot(BoxAxes[1], Axis)), BoxHalfExtents[1], Radius);
+		return VectorMultiplyAdd(VectorAbs(Dot(BoxAxes[2], Axis)), BoxHalfExtents[2], Radius);
+	}
+
+	struct FBoxSweepLanes
+	{
+		FVector4Lanes MovingAxes[3];
+		VectorRegister MovingHalfExtents[3];
+		FVector4Lanes TargetAxes[3];
+		VectorRegister TargetHalfExtents[3];
+		/** Target center minus moving box center. */
+		FVector4Lanes CenterOffset;
+		FVector4Lanes Delta;
+
+		VectorRegister EnterTime;
+		VectorRegister ExitTime;
+		VectorRegister SeparatedMask;
+		FVector4Lanes ImpactNormal;
+
+		/** Narrows the time interval during which the boxes overlap to the interval where they overlap on Axis. */
+		FORCEINLINE void TestAxis(const FVector4Lanes& Axis)
+		{
+			const VectorRegister Zero = VectorZero();
+			const VectorRegister One = VectorOne();
+			const VectorRegister Infinity = VectorSetFloat1(SweepInfinity);
+			const VectorRegister MinusInfinity = VectorSetFloat1(-SweepInfinity);
+
+			const VectorRegister AxisLengthSquared = Dot(Axis, Axis);
+			const VectorRegister ValidMask = VectorCompareGT(AxisLengthSquared, VectorSetFloat1(AxisLengthSquaredEpsilon));
+
+			const VectorRegister Distance = Dot(CenterOffset, Axis);
+			const VectorRegister Velocity = Dot(Delta, Axis);
+			const VectorRegister Radius = VectorAdd(ProjectedRadius(MovingAxes, MovingHalfExtents, Axis), ProjectedRadius(TargetAxes, TargetHalfExtents, Axis));
+
+			// The projections overlap while |Distance - Velocity * t| <= Radius
+			const VectorRegister ParallelMask = VectorCompareGT(VectorSetFloat1(ParallelEpsilon), VectorAbs(Velocity));
+			const VectorRegister InverseVelocity = VectorReciprocalAccurate(VectorSelect(ParallelMask, One, Velocity));
+			const VectorRegister Time0 = VectorMultiply(VectorSubtract(Distance, Radius), InverseVelocity);
+			const VectorRegister Time1 = VectorMultiply(VectorAdd(Distance, Radius), InverseVelocity);
+			VectorRegister AxisEnterTime = VectorSelect(ParallelMask, MinusInfinity, VectorMin(Time0, Time1));
+			VectorRegister AxisExitTime = VectorSelect(ParallelMask, Infinity, VectorMax(Time0, Time1));
+			AxisEnterTime = VectorSelect(ValidMask, AxisEnterTime, MinusInfinity);
+			AxisExitTime = VectorSelect(ValidMask, AxisExitTime, Infinity);
+
+			const VectorRegister ParallelSeparatedMask = VectorBitwiseAnd(ParallelMask, VectorCompareGT(VectorAbs(Distance), Radius));
+			SeparatedMask = VectorBitwiseOr(SeparatedMask, VectorBitwiseAnd(ValidMask, ParallelSeparatedMask));
+
+			// The target faces the moving box on the side opposite to the target's offset along the axis
+			const VectorRegister NewEnterMask = VectorCompareGT(AxisEnterTime, EnterTime);
+			const VectorRegister Side = VectorSelect(VectorCompareGE(Distance, Zero), VectorSetFloat1(-1.f), One);
+			const VectorRegister NormalScale = VectorMultiply(Side, VectorReciprocalSqrtAccurate(VectorSelect(ValidMask, AxisLengthSquared, One)));
+			ImpactNormal.X = VectorSelect(NewEnterMask, VectorMultiply(Axis.X, NormalScale), ImpactNormal.X);
+			ImpactNormal.Y = VectorSelect(NewEnterMask, VectorMultiply(Axis.Y, NormalScale), ImpactNormal.Y);
+			ImpactNormal.Z = VectorSelect(NewEnterMask, VectorMultiply(Axis.Z, NormalScale), ImpactNormal.Z);
+
+			EnterTime = VectorMax(EnterTime, AxisEnterTime);
+			ExitTime = VectorMin(ExitTime, AxisExitTime);
+		}
+	};
+
+	/** Entry time of a ray starting outside the box [-HalfExtents, HalfExtents]. */
+	bool RayCastBox(const FVector& Origin, const FVector& Direction, const FVector& HalfExtents, float& OutTime)
+	{
+		float EnterTime = 0.f;
+		float ExitTime = SweepInfinity;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			if (FMath::Abs(Direction[Axis]) < ParallelEpsilon)
+			{
+				if (FMath::Abs(Origin[Axis]) > HalfExtents[Axis])
+					return false;
+				continue;
+			}
+
+			const float InverseDirection = 1.f / Direction[Axis];
+			float Time0 = (-HalfExtents[Axis] - Origin[Axis]) * InverseDirection;
+			float Time1 = (HalfExtents[Axis] - Origin[Axis]) * InverseDirection;
+			if (Time0 > Time1)
+				Swap(Time0, Time1);
+			EnterTime = FMath::Max(EnterTime, Time0);
+			ExitTime = FMath::Min(ExitTime, Time1);
+			if (EnterTime > ExitTime)
+				return false;
+		}
+
+		OutTime = EnterTime;
+		return true;
+	}
+
+	bool RayCastSphere(const FVector& Origin, const FVector& Direction, const FVector& Center, float Radius, float& OutTime)
+	{
+		const FVector Offset = Origin - Center;
+		const float A = FVector::DotProduct(Direction, Direction);
+		const float B = FVector::DotProduct(Offset, Direction);
+		const float C = FVector::DotProduct(Offset, Offset) - Radius * Radius;
+		const float Discriminant = B * B - A * C;
+		if (A < SMALL_NUMBER || Discriminant < 0.f)
+			return false;
+
+		const float Time = (-B - FMath::Sqrt(Discriminant)) / A;
+		if (Time < 0.f)
+			return false;
+
+		OutTime = Time;
+		return true;
+	}
+
+	/** Entry time of a ray starting outside the capsule around the segment [SegmentStart, SegmentEnd]. */
+	bool RayCastCapsule(const FVector& Origin, const FVector& Direction, const FVector& SegmentStart, const FVector& SegmentEnd, float Radius, float& OutTime)
+	{
+		const FVector Segment = SegmentEnd - SegmentStart;
+		const FVector Offset = Origin - SegmentStart;
+		const float SegmentDotSegment = FVector::DotProduct(Segment, Segment);
+		const float SegmentDotDirection = FVector::DotProduct(Segment, Direction);
+		const float SegmentDotOffset = FVector::DotProduct(Segment, Offset);
+		const float DirectionDotOffset = FVector::DotProduct(Direction, Offset);
+		const float DirectionDotDirection = FVector::DotProduct(Direction, Direction);
+		const float OffsetDotOffset = FVector::DotProduct(Offset, Offset);
+
+		// Infinite cylinder around the segment, clipped to the segment's extent
+		const float A = SegmentDotSegment * DirectionDotDirection - SegmentDotDirection * SegmentDotDirection;
+		const float B = SegmentDotSegment * DirectionDotOffset - SegmentDotOffset * SegmentDotDirection;
+		const float C = SegmentDotSegment * OffsetDotOffset - SegmentDotOffset * SegmentDotOffset - Radius * Radius * SegmentDotSegment;
+		const float Discriminant = B * B - A * C;
+		if (A > SMALL_NUMBER && Discriminant >= 0.f)
+		{
+			const float Time = (-B - FMath::Sqrt(Discriminant)) / A;
+			const float SegmentPosition = SegmentDotOffset + Time * SegmentDotDirection;
+			if (Time >= 0.f && SegmentPosition > 0.f && SegmentPosition < SegmentDotSegment)
+			{
+				OutTime = Time;
+				return true;
+			}
+		}
+
+		// Otherwise the ray can only enter through one of the end caps
+		float StartCapTime = SweepInfinity;
+		float EndCapTime = SweepInfinity;
+		const bool bHitStartCap = RayCastSphere(Origin, Direction, SegmentStart, Radius, StartCapTime);
+		const bool bHitEndCap = RayCastSphere(Origin, Direction, SegmentEnd, Radius, EndCapTime);
+		OutTime = FMath::Min(StartCapTime, EndCapTime);
+		return bHitStartCap || bHitEndCap;
+	}
+}
+
+void FAnalyticSweep::SweepBoxesAgainstBoxes(TArrayView<const FAnalyticBox> MovingBoxes, TArrayView<const FVector> Deltas, TArrayView<const FAnalyticBox> TargetBoxes, TArrayView<FAnalyticSweepHit> OutHits)
+{
+	check(MovingBoxes.Num() == Deltas.Num() && MovingBoxes.Num() == TargetBoxes.Num() && MovingBoxes.Num() == OutHits.Num());
+
+	const int32 NumFullGroups = MovingBoxes.Num() / NumLanes;
+	for (int32 Group = 0; Group < NumFullGroups; Group++)
+	{
+		const int32 First = Group * NumLanes;
+		SweepBoxesAgainstBoxesLanes(&MovingBoxes[First], &Deltas[First], &TargetBoxes[First], &OutHits[First]);
+	}
+
+	// Pad the last group by repeating its first query
+	const int32 First = NumFullGroups * NumLanes;
+	const int32 NumRemaining = MovingBoxes.Num() - First;
+	if (NumRemaining > 0)
+	{
+		FAnalyticBox PaddedMovingBoxes[NumLanes];
+		FVector PaddedDeltas[NumLanes];
+		FAnalyticBox PaddedTargetBoxes[NumLanes];
+		FAnalyticSweepHit PaddedHits[NumLanes];
+		for (int32 Lane = 0; Lane < NumLanes; Lane++)
+		{
+			const int32 Index = First + (Lane < NumRemaining ? Lane : 0);
+			PaddedMovingBoxes[Lane] = MovingBoxes[Index];
+			PaddedDeltas[Lane] = Deltas[Index];
+			PaddedTargetBoxes[Lane] = TargetBoxes[Index];
+		}
+
+		SweepBoxesAgainstBoxesLanes(PaddedMovingBoxes, PaddedDeltas, PaddedTargetBoxes, PaddedHits);
+		for (int32 Lane = 0; Lane < NumRemaining; Lane++)
+			OutHits[First + Lane] = PaddedHits[Lane];
+	}
+}
+
+void FAnalyticSweep::SweepSpheresAgainstBoxes(TArrayView<const FVector> SphereCenters, TArrayView<const float> SphereRadii, TArrayView<const FVector> Deltas, TArrayView<const FAnalyticBox> TargetBoxes, TArrayView<FAnalyticSweepHit> OutHits)
+{
+	check(SphereCenters.Num() == SphereRadii.Num() && SphereCenters.Num() == Deltas.Num() && SphereCenters.Num() == TargetBoxes.Num() && SphereCenters.Num() == OutHits.Num());
+
+	for (int32 Index = 0; Index < SphereCenters.Num(); Index++)
+		OutHits[Index] = SweepSphereAgainstBox(SphereCenters[Index], SphereRadii[Index], Deltas[Index], TargetBoxes[Index]);
+}
+
+FAnalyticSweepHit FAnalyticSweep::SweepBoxAgainstBox(const FAnalyticBox& MovingBox, const FVector& Delta, const FAnalyticBox& TargetBox)
+{
+	FAnalyticSweepHit Hit;
+	SweepBoxesAgainstBoxes(MakeArrayView(&MovingBox, 1), MakeArrayView(&Delta, 1), MakeArrayView(&TargetBox, 1), MakeArrayView(&Hit, 1));
+	return Hit;
+}
+
+FAnalyticSweepHit FAnalyticSweep::SweepSphereAgainstBox(const FVector& SphereCenter, float SphereRadius, const FVector& Delta, const FAnalyticBox& TargetBox)
+{
+	FAnalyticSweepHit Hit;
+
+	// Work in the local space of the box, where it spans [-HalfExtents, HalfExtents]
+	const FVector Origin = TargetBox.Rotation.UnrotateVector(SphereCenter - TargetBox.Center);
+	const FVector Direction = TargetBox.Rotation.UnrotateVector(Delta);
+	const FVector& HalfExtents = TargetBox.HalfExtents;
+
+	auto ClosestPointOnBox = [&](const FVector& Point) { return Point.BoundToBox(-HalfExtents, HalfExtents); };
+
+	float ImpactTime = SweepInfinity;
+	if (FVector::DistSquared(Origin, ClosestPointOnBox(Origin)) <= SphereRadius * SphereRadius)
+	{
+		ImpactTime = 0.f;
+		Hit.bStartPenetrating = true;
+	}
+	else
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			FVector InflatedHalfExtents = HalfExtents;
+			InflatedHalfExtents[Axis] += SphereRadius;
+			float Time;
+			if (RayCastBox(Origin, Direction, InflatedHalfExtents, Time))
+				ImpactTime = FMath::Min(ImpactTime, Time);
+		}
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const int32 Axis1 = (Axis + 1) % 3;
+			const int32 Axis2 = (Axis + 2) % 3;
+			for (int32 Corner = 0; Corner < 4; Corner++)
+			{
+				FVector SegmentStart;
+				SegmentStart[Axis] = -HalfExtents[Axis];
+				SegmentStart[Axis1] = (Corner & 1) ? HalfExtents[Axis1] : -HalfExtents[Axis1];
+				SegmentStart[Axis2] = (Corner & 2) ? HalfExtents[Axis2] : -HalfExtents[Axis2];
+				FVector SegmentEnd = SegmentStart;
+				SegmentEnd[Axis] = HalfExtents[Axis];
+
+				float Time;
+				if (RayCastCapsule(Origin, Direction, SegmentStart, SegmentEnd, SphereRadius, Time))
+					ImpactTime = FMath::Min(ImpactTime, Time);
+			}
+		}
+	}
+
+	if (ImpactTime > 1.f)
+		return Hit;
+
+	const FVector CenterAtImpact = Origin + Direction * ImpactTime;
+	const FVector ImpactPoint = ClosestPointOnBox(CenterAtImpact);
+	Hit.bBlockingHit = true;
+	Hit.Time = ImpactTime;
+	Hit.ImpactPoint = TargetBox.Center + TargetBox.Rotation.RotateVector(ImpactPoint);
+	Hit.ImpactNormal = TargetBox.Rotation.RotateVector((CenterAtImpact - ImpactPoint).GetSafeNormal());
+	return Hit;
+}
+
+void FAnalyticSweep::SweepBoxesAgainstBoxesLanes(const FAnalyticBox* MovingBoxes, const FVector* Deltas, const FAnalyticBox* TargetBoxes, FAnalyticSweepHit* OutHits)
+{
+	FBoxSweepLanes Lanes;
+	Lanes.MovingAxes[0] = GatherLanes([&](int32 Lane) { return MovingBoxes[Lane].Rotation.GetAxisX(); });
+	Lanes.MovingAxes[1] = GatherLanes([&](int32 Lane) { return MovingBoxes[Lane].Rotation.GetAxisY(); });
+	Lanes.MovingAxes[2] = GatherLanes([&](int32 Lane) { return MovingBoxes[Lane].Rotation.GetAxisZ(); });
+	Lanes.TargetAxes[0] = GatherLanes([&](int32 Lane) { return TargetBoxes[Lane].Rotation.GetAxisX(); });
+	Lanes.TargetAxes[1] = GatherLanes([&](int32 Lane) { return TargetBoxes[Lane].Rotation.GetAxisY(); });
+	Lanes.TargetAxes[2] = GatherLanes([&](int32 Lane) { return TargetBoxes[Lane].Rotation.GetAxisZ(); });
+
+	const FVector4Lanes MovingHalfExtents = GatherLanes([&](int32 Lane) { return MovingBoxes[Lane].HalfExtents; });
+	const FVector4Lanes TargetHalfExtents = GatherLanes([&](int32 Lane) { return TargetBoxes[Lane].HalfExtents; });
+	Lanes.MovingHalfExtents[0] = MovingHalfExtents.X;
+	Lanes.MovingHalfExtents[1] = MovingHalfExtents.Y;
+	Lanes.MovingHalfExtents[2] = MovingHalfExtents.Z;
+	Lanes.TargetHalfExtents[0] = TargetHalfExtents.X;
+	Lanes.TargetHalfExtents[1] = TargetHalfExtents.Y;
+	Lanes.TargetHalfExtents[2] = TargetHalfExtents.Z;
+
+	Lanes.CenterOffset = GatherLanes([&](int32 Lane) { return TargetBoxes[Lane].Center - MovingBoxes[Lane].Center; });
+	Lanes.Delta = GatherLanes([&](int32 Lane) { return Deltas[Lane]; });
+
+	Lanes.EnterTime = VectorSetFloat1(-SweepInfinity);
+	Lanes.ExitTime = VectorSetFloat1(SweepInfinity);
+	Lanes.SeparatedMask = VectorZero();
+	Lanes.ImpactNormal = FVector4Lanes{ VectorZero(), VectorZero(), VectorZero() };
+
+	for (int32 MovingAxis = 0; MovingAxis < 3; MovingAxis++)
+		Lanes.TestAxis(Lanes.MovingAxes[MovingAxis]);
+	for (int32 TargetAxis = 0; TargetAxis < 3; TargetAxis++)
+		Lanes.TestAxis(Lanes.TargetAxes[TargetAxis]);
+	for (int32 MovingAxis = 0; MovingAxis < 3; MovingAxis++)
+		for (int32 TargetAxis = 0; TargetAxis < 3; TargetAxis++)
+			Lanes.TestAxis(Cross(Lanes.MovingAxes[MovingAxis], Lanes.TargetAxes[TargetAxis]));
+
+	const VectorRegister HitMask = VectorBitwiseAnd(
+		VectorBitwiseAnd(VectorCompareGE(Lanes.ExitTime, Lanes.EnterTime), VectorCompareGE(VectorOne(), Lanes.EnterTime)),
+		VectorCompareGE(Lanes.ExitTime, VectorZero()));
+	const int32 HitBits = VectorMaskBits(HitMask) & ~VectorMaskBits(Lanes.SeparatedMask);
+
+	MS_ALIGN(16) float EnterTimes[NumLanes] GCC_ALIGN(16);
+	MS_ALIGN(16) float NormalsX[NumLanes] GCC_ALIGN(16);
+	MS_ALIGN(16) float NormalsY[NumLanes] GCC_ALIGN(16);
+	MS_ALIGN(16) float NormalsZ[NumLanes] GCC_ALIGN(16);
+	VectorStoreAligned(Lanes.EnterTime, EnterTimes);
+	VectorStoreAligned(Lanes.ImpactNormal.X, NormalsX);
+	VectorStoreAligned(Lanes.ImpactNormal.Y, NormalsY);
+	VectorStoreAligned(Lanes.ImpactNormal.Z, NormalsZ);
+
+	for (int32 Lane = 0; Lane < NumLanes; Lane++)
+	{
+		FAnalyticSweepHit& Hit = OutHits[Lane];
+		Hit = FAnalyticSweepHit();
+		if (!(HitBits & (1 << Lane)))
+			continue;
+
+		Hit.bBlockingHit = true;
+		Hit.bStartPenetrating = EnterTimes[Lane] < 0.f;
+		Hit.Time = FMath::Max(EnterTimes[Lane], 0.f);
+		Hit.ImpactNormal = FVector{ NormalsX[Lane], NormalsY[Lane], NormalsZ[Lane] };
+	}
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Oriented box: world space center, rotation and half extents. */
+struct SKELETALMESHCOLLIDER_API FAnalyticBox
+{
+	FVector Center = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector HalfExtents = FVector::ZeroVector;
+};
+
+struct SKELETALMESHCOLLIDER_API FAnalyticSweepHit
+{
+	bool bBlockingHit = false;
+	bool bStartPenetrating = false;
+	/** Fraction of the sweep at the time of impact, 0 when the shapes overlap at the start. */
+	float Time = 1.f;
+	/** Normal of the target surface at the impact, pointing towards the moving shape. */
+	FVector ImpactNormal = FVector::ZeroVector;
+	/** Contact point on the target; only computed for sphere sweeps. */
+	FVector ImpactPoint = FVector::ZeroVector;
+};
+
+/**
+ * Closed form sweeps of a box or a sphere against a static oriented box, independent of the physics engine.
+ *
+ * Box sweeps use the separating axis test on the 15 candidate axes, extended to linear motion: each axis gives
+ * the time interval during which the projections overlap, and the shapes touch when all intervals intersect.
+ * They are evaluated NumLanes queries at a time, one query per SIMD lane.
+ *
+ * Sphere sweeps are ray casts against the box inflated by the radius, which is the union of three slab
+ * inflated boxes and twelve edge capsules; they are evaluated one query at a time.
+ */
+class SKELETALMESHCOLLIDER_API FAnalyticSweep
+{
+public:
+	static constexpr int32 NumLanes = 4;
+
+	/** Sweeps MovingBoxes[N] by Deltas[N] against TargetBoxes[N]. All views must have the same length. */
+	static void SweepBoxesAgainstBoxes(TArrayView<const FAnalyticBox> MovingBoxes, TArrayView<const FVector> Deltas, TArrayView<const FAnalyticBox> TargetBoxes, TArrayView<FAnalyticSweepHit> OutHits);
+
+	/** Sweeps spheres with SphereCenters[N] and SphereRadii[N] by Deltas[N] against TargetBoxes[N]. */
+	static void SweepSpheresAgainstBoxes(TArrayView<const FVector> SphereCenters, TArrayView<const float> SphereRadii, TArrayView<const FVector> Deltas, TArrayView<const FAnalyticBox> TargetBoxes, TArrayView<FAnalyticSweepHit> OutHits);
+
+	static FAnalyticSweepHit SweepBoxAgainstBox(const FAnalyticBox& MovingBox, const FVector& Delta, const FAnalyticBox& TargetBox);
+	static FAnalyticSweepHit SweepSphereAgainstBox(const FVector& SphereCenter, float SphereRadius, const FVector& Delta, const FAnalyticBox& TargetBox);
+
+private:
+	static void SweepBoxesAgainstBoxesLanes(const FAnalyticBox* MovingBoxes, const FVector* Deltas, const FAnalyticBox* TargetBoxes, FAnalyticSweepHit* OutHits);
+};
@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AsyncComponentSweepSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "DeferredPhysicsStateSubsystem.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+namespace
+{
+	/** Requests per ParallelFor task; a chunk shares its scratch arrays. */
+	const int32 RequestsPerChunk = 16;
+}
+
+void UAsyncComponentSweepSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UAsyncComponentSweepSubsystem::OnWorldTickStart);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UAsyncComponentSweepSubsystem::OnWorldPostActorTick);
+}
+
+void UAsyncComponentSweepSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	// The sweeps in flight read the world, so they must be done before it goes; their delegates are not run
+	if (InFlightTask.IsValid())
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(InFlightTask, ENamedThreads::GameThread);
+	InFlightTask = nullptr;
+	PendingRequests.Reset();
+	InFlightRequests.Reset();
+	CompletedRequests.Reset();
+	Super::Deinitialize();
+}
+
+FTraceHandle UAsyncComponentSweepSubsystem::AsyncComponentSweepMulti(UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, const FComponentSweepDelegate* InDelegate, uint32 UserData)
+{
+	check(IsInGameThread());
+
+	const FTraceHandle Handle(PendingFrame, PendingRequests.Num());
+	FRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Datum.Component = Component;
+	Request.Datum.Start = Start;
+	Request.Datum.End = End;
+	Request.Datum.Rot = Rot;
+	Request.Datum.UserData = UserData;
+	Request.Params = Params;
+	if (InDelegate)
+		Request.Delegate = *InDelegate;
+
+	USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(Component);
+	if (UDeferredPhysicsStateSubsystem* DeferredPhysicsState = SkeletalMeshComponent ? GetWorld()->GetSubsystem<UDeferredPhysicsStateSubsystem>() : nullptr)
+		DeferredPhysicsState->CreateDeferredPhysicsState(*SkeletalMeshComponent);
+
+	// Without query collision there is nothing to sweep, which a request without shapes does
+	if (!Component || !Component->IsQueryCollisionEnabled())
+	{
+		Request.bCaptured = true;
+		return Handle;
+	}
+
+	Request.TraceChannel = Component->GetCollisionObjectType();
+	Request.ResponseParams = FCollisionResponseParams(Component->GetCollisionResponseToChannels());
+	CaptureShapes(Request, *Component);
+	return Handle;
+}
+
+bool UAsyncComponentSweepSubsystem::QueryComponentSweepData(const FTraceHandle& Handle, FComponentSweepDatum& OutData) const
+{
+	if (CompletedFrame == 0 || Handle._Data.FrameNumber != CompletedFrame || !CompletedRequests.IsValidIndex(Handle._Data.Index))
+		return false;
+
+	OutData = CompletedRequests[Handle._Data.Index].Datum;
+	return true;
+}
+
+bool UAsyncComponentSweepSubsystem::IsComponentSweepHandleValid(const FTraceHandle& Handle) const
+{
+	const uint32 FrameNumber = Handle._Data.FrameNumber;
+	const int32 Index = Handle._Data.Index;
+	return (FrameNumber == PendingFrame && PendingRequests.IsValidIndex(Index))
+		|| (InFlightFrame != 0 && FrameNumber == InFlightFrame && InFlightRequests.IsValidIndex(Index))
+		|| (CompletedFrame != 0 && FrameNumber == CompletedFrame && CompletedRequests.IsValidIndex(Index));
+}
+
+void UAsyncComponentSweepSubsystem::StartAsyncSweeps()
+{
+	check(IsInGameThread());
+
+	// Called twice without a tick start in between, as tests do: the previous batch becomes the completed one
+	if (InFlightTask.IsValid() || InFlightFrame != 0)
+		FinishAsyncSweeps();
+
+	const UWorld* World = GetWorld();
+	InFlightRequests = MoveTemp(PendingRequests);
+	PendingRequests.Reset();
+	InFlightFrame = PendingFrame;
+	PendingFrame = PendingFrame == MAX_uint32 ? 1 : PendingFrame + 1;
+	if (!World || InFlightRequests.Num() == 0)
+		return;
+
+	for (FRequest& Request : InFlightRequests)
+	{
+		UPrimitiveComponent* Component = Request.Datum.Component.Get();
+		if (!Request.bCaptured && Component)
+			Request.Datum.bBlockingHit = World->ComponentSweepMulti(Request.Datum.OutHits, Component, Request.Datum.Start, Request.Datum.End, Request.Datum.Rot, Request.Params);
+	}
+
+	InFlightTask = FFunctionGraphTask::CreateAndDispatchWhenReady([this, World]()
+		{
+			const int32 NumRequests = InFlightRequests.Num();
+			const int32 NumChunks = FMath::DivideAndRoundUp(NumRequests, RequestsPerChunk);
+			ParallelFor(NumChunks, [this, World, NumRequests](int32 ChunkIndex)
+				{
+					TArray<FTransform> ShapeStarts;
+					TArray<FHitResult> ScratchHits;
+					const int32 FirstRequest = ChunkIndex * RequestsPerChunk;
+					const int32 LastRequest = FMath::Min(FirstRequest + RequestsPerChunk, NumRequests);
+					for (int32 RequestIndex = FirstRequest; RequestIndex < LastRequest; RequestIndex++)
+						if (InFlightRequests[RequestIndex].bCaptured)
+							SweepCaptured(*World, InFlightRequests[RequestIndex], ShapeStarts, ScratchHits);
+				}, !FApp::ShouldUseThreadingForPerformance());
+		}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+void UAsyncComponentSweepSubsystem::FinishAsyncSweeps()
+{
+	check(IsInGameThread());
+
+	if (InFlightTask.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(InFlightTask, ENamedThreads::GameThread);
+		InFlightTask = nullptr;
+	}
+
+	CompletedRequests = MoveTemp(InFlightRequests);
+	InFlightRequests.Reset();
+	CompletedFrame = InFlightFrame;
+	InFlightFrame = 0;
+
+	// Delegates may make new requests, which go to the pending ones and leave these untouched
+	for (int32 Index = 0; Index < CompletedRequests.Num(); Index++)
+	{
+		FRequest& Request = CompletedRequests[Index];
+		Request.SharedShapes.Reset();
+		Request.Delegate.ExecuteIfBound(FTraceHandle(CompletedFrame, Index), Request.Datum);
+	}
+}
+
+void UAsyncComponentSweepSubsystem::OnWorldTickStart(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (TickedWorld == GetWorld())
+		FinishAsyncSweeps();
+}
+
+void UAsyncComponentSweepSubsystem::OnWorldPostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (TickedWorld == GetWorld())
+		StartAsyncSweeps();
+}
+
+void UAsyncComponentSweepSubsystem::CaptureShapes(FRequest& Request, UPrimitiveComponent& Component)
+{
+	if (USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(&Component))
+	{
+		USkeletalMeshSweepSubsystem* SweepSubsystem = GetWorld()->GetSubsystem<USkeletalMeshSweepSubsystem>();
+		const FSkeletalMeshBodyShapeCache* BodyShapes = SweepSubsystem ? &SweepSubsystem->GetBodyShapes(*SkeletalMeshComponent) : nullptr;
+		if (BodyShapes && BodyShapes->IsSupported())
+		{
+			Request.SharedShapes = BodyShapes->GetShared();
+			Request.bCaptured = true;
+		}
+		return;
+	}
+
+	// UWorld::ComponentSweepMulti sweeps the shapes welded into the body too, so they are captured with it
+	Request.bCaptured = USkeletalMeshSweepSubsystem::GetWeldedShapes(Component, Request.Shapes);
+}
+
+void UAsyncComponentSweepSubsystem::SweepCaptured(const UWorld& World, FRequest& Request, TArray<FTransform>& ShapeStarts, TArray<FHitResult>& ScratchHits)
+{
+	const TArray<FCachedBodyShape>& Shapes = Request.SharedShapes.IsValid() ? Request.SharedShapes->Shapes : Request.Shapes;
+	FComponentSweepDatum& Datum = Request.Datum;
+	USkeletalMeshSweepSubsystem::GetShapeStarts(Shapes, Datum.Start, Datum.Rot, ShapeStarts);
+	USkeletalMeshSweepSubsystem::SweepShapes(World, Shapes, ShapeStarts, Datum.Start, Datum.End, Request.TraceChannel, Request.Params, Request.ResponseParams, ScratchHits, Datum.OutHits);
+	Datum.bBlockingHit = USkeletalMeshSweepSubsystem::FinalizeSweepHits(Datum.OutHits);
+}
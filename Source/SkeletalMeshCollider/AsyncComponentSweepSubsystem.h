@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "CollisionQueryParams.h"
+#include "Engine/EngineTypes.h"
+#include "SkeletalMeshBodyShapeCache.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "AsyncComponentSweepSubsystem.generated.h"
+
+class UPrimitiveComponent;
+
+/** Request and results of an async component sweep, the counterpart of FTraceDatum. */
+struct SKELETALMESHCOLLIDER_API FComponentSweepDatum
+{
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FQuat Rot = FQuat::Identity;
+	/** Same contents as the hits of UWorld::ComponentSweepMulti. */
+	TArray<FHitResult> OutHits;
+	bool bBlockingHit = false;
+	uint32 UserData = 0;
+};
+
+DECLARE_DELEGATE_TwoParams(FComponentSweepDelegate, const FTraceHandle&, FComponentSweepDatum&);
+
+/**
+ * ComponentSweepMulti in the frame pipelined style of UWorld::AsyncSweepByChannel: requests made during a frame are
+ * swept on worker threads once the actors of the world have ticked, and their results are available, through
+ * QueryComponentSweepData or the delegate of the request, during the next frame only.
+ *
+ * The shapes of the component are captured when the request is made, so it may move or be destroyed afterwards.
+ * Skeletal mesh components use the body shapes of USkeletalMeshSweepSubsystem; box, sphere and capsule components
+ * use their collision shape plus those of the shape components welded to them. Components that can't be captured
+ * that way are swept with UWorld::ComponentSweepMulti on the game thread when the batch starts, and still report
+ * their results on the next frame.
+ */
+UCLASS()
+class SKELETALMESHCOLLIDER_API UAsyncComponentSweepSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	FTraceHandle AsyncComponentSweepMulti(UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, const FComponentSweepDelegate* InDelegate = nullptr, uint32 UserData = 0);
+
+	/** Copies the results of Handle; only succeeds during the frame after the request. */
+	bool QueryComponentSweepData(const FTraceHandle& Handle, FComponentSweepDatum& OutData) const;
+	bool IsComponentSweepHandleValid(const FTraceHandle& Handle) const;
+
+	/** Starts sweeping the requests of this frame on worker threads; called after every actor tick of the world. */
+	void StartAsyncSweeps();
+
+	/**
+	 * Waits for the sweeps started last frame, makes their results queryable and runs their delegates; called when
+	 * the next tick of the world starts.
+	 */
+	void FinishAsyncSweeps();
+
+private:
+	struct FRequest
+	{
+		FComponentSweepDatum Datum;
+		FComponentQueryParams Params;
+		FComponentSweepDelegate Delegate;
+		ECollisionChannel TraceChannel = ECC_WorldStatic;
+		FCollisionResponseParams ResponseParams;
+		/** Body shapes of a skeletal mesh component, kept alive until the request completes. */
+		TSharedPtr<const FSharedBodyShapes> SharedShapes;
+		/** Shapes of a shape component and of the shape components welded to it. */
+		TArray<FCachedBodyShape> Shapes;
+		/** False if the shapes could not be captured and the component is swept on the game thread. */
+		bool bCaptured = false;
+	};
+
+	void OnWorldTickStart(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldPostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds);
+	void CaptureShapes(FRequest& Request, UPrimitiveComponent& Component);
+	static void SweepCaptured(const UWorld& World, FRequest& Request, TArray<FTransform>& ShapeStarts, TArray<FHitResult>& ScratchHits);
+
+	TArray<FRequest> PendingRequests;
+	TArray<FRequest> InFlightRequests;
+	TArray<FRequest> CompletedRequests;
+	FGraphEventRef InFlightTask;
+	/** Frame numbers stored in the handles; frame 0 is never used, so default handles are never valid. */
+	uint32 PendingFrame = 1;
+	uint32 InFlightFrame = 0;
+	uint32 CompletedFrame = 0;
+
+	FDelegateHandle TickStartHandle;
+	FDelegateHandle PostActorTickHandle;
+};
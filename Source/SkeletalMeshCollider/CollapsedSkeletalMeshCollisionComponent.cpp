@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CollapsedSkeletalMeshCollisionComponent.h"
+
+#include "Engine/CollisionProfile.h"
+#include "Engine/SkeletalMesh.h"
+#include "PhysicsAssetCollapse.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+
+UCollapsedSkeletalMeshCollisionComponent::UCollapsedSkeletalMeshCollisionComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SetCollisionProfileName(UCollisionProfile::BlockAllDynamic_ProfileName);
+	bHiddenInGame = true;
+}
+
+void UCollapsedSkeletalMeshCollisionComponent::SetSkeletalMesh(USkeletalMesh* NewSkeletalMesh)
+{
+	if (SkeletalMesh == NewSkeletalMesh)
+		return;
+
+	SkeletalMesh = NewSkeletalMesh;
+	Bake();
+}
+
+void UCollapsedSkeletalMeshCollisionComponent::SetSkeletalMeshNeverAnimates(bool bNeverAnimates)
+{
+	if (bSkeletalMeshNeverAnimates == bNeverAnimates)
+		return;
+
+	bSkeletalMeshNeverAnimates = bNeverAnimates;
+	Bake();
+}
+
+bool UCollapsedSkeletalMeshCollisionComponent::Bake()
+{
+	if (!BakedBodySetup)
+		BakedBodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transactional);
+
+	const bool bBaked = BakeInto(*BakedBodySetup);
+	if (IsRegistered())
+	{
+		RecreatePhysicsState();
+		UpdateBounds();
+	}
+	return bBaked;
+}
+
+bool UCollapsedSkeletalMeshCollisionComponent::IsBaked() const
+{
+	return BakedBodySetup && BakedBodySetup->AggGeom.GetElementCount() > 0;
+}
+
+bool UCollapsedSkeletalMeshCollisionComponent::BakeInto(UBodySetup& BodySetup) const
+{
+	BodySetup.InvalidatePhysicsData();
+	BodySetup.CollisionTraceFlag = ECollisionTraceFlag::CTF_UseSimpleAsComplex;
+
+	const UPhysicsAsset* PhysicsAsset = SkeletalMesh ? SkeletalMesh->PhysicsAsset : nullptr;
+	if (!PhysicsAsset || !FPhysicsAssetCollapse::Bake(*SkeletalMesh, *PhysicsAsset, bSkeletalMeshNeverAnimates, BodySetup.AggGeom))
+	{
+		BodySetup.AggGeom.EmptyElements();
+		return false;
+	}
+
+	const USkeletalBodySetup* FirstBodySetup = PhysicsAsset->SkeletalBodySetups.Num() > 0 ? PhysicsAsset->SkeletalBodySetups[0] : nullptr;
+	BodySetup.PhysMaterial = FirstBodySetup ? FirstBodySetup->PhysMaterial : nullptr;
+	BodySetup.CreatePhysicsMeshes();
+	return true;
+}
+
+UBodySetup* UCollapsedSkeletalMeshCollisionComponent::GetBodySetup()
+{
+	return IsBaked() ? BakedBodySetup : nullptr;
+}
+
+FBoxSphereBounds UCollapsedSkeletalMeshCollisionComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!IsBaked())
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+
+	return FBoxSphereBounds(BakedBodySetup->AggGeom.CalcAABB(LocalToWorld));
+}
+
+void UCollapsedSkeletalMeshCollisionComponent::OnRegister()
+{
+	// The body setup must exist before the physics state is created, which happens during registration
+	if (!BakedBodySetup && SkeletalMesh)
+		Bake();
+
+	Super::OnRegister();
+}
+
+void UCollapsedSkeletalMeshCollisionComponent::PreSave(const class ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+#if WITH_EDITOR
+	if (BakedBodySetup)
+		BakeInto(*BakedBodySetup);
+#endif
+}
+
+#if WITH_EDITOR
+void UCollapsedSkeletalMeshCollisionComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(UCollapsedSkeletalMeshCollisionComponent, SkeletalMesh)
+		|| PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(UCollapsedSkeletalMeshCollisionComponent, bSkeletalMeshNeverAnimates))
+		Bake();
+
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+#endif
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "CollapsedSkeletalMeshCollisionComponent.generated.h"
+
+class UBodySetup;
+class USkeletalMesh;
+
+/**
+ * Collision of a skeletal mesh that never animates, as a single body whose shapes are the physics asset bodies
+ * collapsed into component space by FPhysicsAssetCollapse. Queries against it cost as much as against a static
+ * mesh component, instead of composing the pose with every body. It has no visual representation of its own.
+ * Nothing is baked until bSkeletalMeshNeverAnimates confirms that the mesh is only ever shown in its ref pose.
+ *
+ * The body setup is baked when the component is registered without one, when SkeletalMesh changes in the editor
+ * and every time the component is saved, which includes cooking, so cooked builds load it ready to use.
+ */
+UCLASS(ClassGroup = Collision, meta = (BlueprintSpawnableComponent))
+class SKELETALMESHCOLLIDER_API UCollapsedSkeletalMeshCollisionComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCollapsedSkeletalMeshCollisionComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	void SetSkeletalMesh(USkeletalMesh* NewSkeletalMesh);
+	USkeletalMesh* GetSkeletalMesh() const { return SkeletalMesh; }
+
+	void SetSkeletalMeshNeverAnimates(bool bNeverAnimates);
+	bool GetSkeletalMeshNeverAnimates() const { return bSkeletalMeshNeverAnimates; }
+
+	/**
+	 * Rebakes the body setup from the physics asset of SkeletalMesh and recreates the physics state. Returns false,
+	 * and leaves the component without collision, if bSkeletalMeshNeverAnimates isn't set or the physics asset
+	 * can't be collapsed.
+	 */
+	bool Bake();
+
+	bool IsBaked() const;
+
+	virtual UBodySetup* GetBodySetup() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	virtual void OnRegister() override;
+	virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	/** Rebakes into the existing body setup; new objects can't be created while saving. */
+	bool BakeInto(UBodySetup& BodySetup) const;
+
+	UPROPERTY(EditAnywhere, Category = Collision)
+	USkeletalMesh* SkeletalMesh = nullptr;
+
+	/** Confirms that SkeletalMesh is never animated wherever this collision stands in for it. */
+	UPROPERTY(EditAnywhere, Category = Collision)
+	bool bSkeletalMeshNeverAnimates = false;
+
+	UPROPERTY()
+	UBodySetup* BakedBodySetup = nullptr;
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ComponentSweepBatch.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+
+namespace
+{
+	/** Requests per ParallelFor task; a chunk shares one scratch hit array. */
+	const int32 RequestsPerChunk = 16;
+}
+
+void FComponentSweepBatch::ComponentSweepMulti(const UWorld* World, TArrayView<const FComponentSweepRequest> Requests, FComponentSweepBatchResults& OutResults, int32 MaxHitsPerRequest)
+{
+	check(IsInGameThread());
+	check(World);
+	check(MaxHitsPerRequest > 0);
+
+	const int32 NumRequests = Requests.Num();
+	OutResults.Hits.SetNum(NumRequests * MaxHitsPerRequest, false);
+	OutResults.Offsets.SetNum(NumRequests, false);
+	OutResults.NumHits.SetNum(NumRequests, false);
+	OutResults.BlockingHitFound.SetNum(NumRequests, false);
+	OutResults.Truncated.SetNum(NumRequests, false);
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumRequests, RequestsPerChunk);
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+		{
+			TArray<FHitResult> ScratchHits;
+			ScratchHits.Reserve(MaxHitsPerRequest);
+
+			const int32 FirstRequest = ChunkIndex * RequestsPerChunk;
+			const int32 LastRequest = FMath::Min(FirstRequest + RequestsPerChunk, NumRequests);
+			for (int32 RequestIndex = FirstRequest; RequestIndex < LastRequest; RequestIndex++)
+			{
+				const FComponentSweepRequest& Request = Requests[RequestIndex];
+				const int32 Offset = RequestIndex * MaxHitsPerRequest;
+				OutResults.Offsets[RequestIndex] = Offset;
+
+				ScratchHits.Reset();
+				OutResults.BlockingHitFound[RequestIndex] = Request.Component
+					&& World->ComponentSweepMulti(ScratchHits, Request.Component, Request.Start, Request.End, Request.Rotation, Request.Params);
+
+				const int32 NumHits = FMath::Min(ScratchHits.Num(), MaxHitsPerRequest);
+				OutResults.NumHits[RequestIndex] = NumHits;
+				OutResults.Truncated[RequestIndex] = ScratchHits.Num() > MaxHitsPerRequest;
+
+				for (int32 HitIndex = 0; HitIndex < NumHits; HitIndex++)
+					OutResults.Hits[Offset + HitIndex] = ScratchHits[HitIndex];
+
+				// ComponentSweepMulti puts the blocking hit last; keep it when the touching hits do not fit
+				if (OutResults.Truncated[RequestIndex])
+					OutResults.Hits[Offset + NumHits - 1] = ScratchHits.Last();
+			}
+		}, !FApp::ShouldUseThreadingForPerformance());
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Engine/EngineTypes.h"
+
+class UPrimitiveComponent;
+class UWorld;
+
+/** One ComponentSweepMulti query in a batch; same meaning as the arguments of UWorld::ComponentSweepMulti. */
+struct SKELETALMESHCOLLIDER_API FComponentSweepRequest
+{
+	UPrimitiveComponent* Component = nullptr;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FComponentQueryParams Params;
+};
+
+/**
+ * Results of a batch, stored in one flat hit buffer.
+ *
+ * Request N owns the slots [N * MaxHitsPerRequest, (N + 1) * MaxHitsPerRequest) of Hits, of which the first
+ * NumHits[N] are valid. The arrays keep their allocations between batches when the same object is reused.
+ */
+struct SKELETALMESHCOLLIDER_API FComponentSweepBatchResults
+{
+	TArray<FHitResult> Hits;
+	TArray<int32> Offsets;
+	TArray<int32> NumHits;
+	/** Return value of ComponentSweepMulti for each request: true if a blocking hit was found. */
+	TArray<bool> BlockingHitFound;
+	/** True for requests that returned more than MaxHitsPerRequest hits; the blocking hit is always kept. */
+	TArray<bool> Truncated;
+
+	TArrayView<const FHitResult> GetHits(int32 RequestIndex) const
+	{
+		return TArrayView<const FHitResult>(Hits.GetData() + Offsets[RequestIndex], NumHits[RequestIndex]);
+	}
+};
+
+class SKELETALMESHCOLLIDER_API FComponentSweepBatch
+{
+public:
+	/**
+	 * Runs UWorld::ComponentSweepMulti for every request, spread over the task graph with ParallelFor.
+	 *
+	 * Must be called from the game thread; the components and the world must not change until it returns.
+	 */
+	static void ComponentSweepMulti(const UWorld* World, TArrayView<const FComponentSweepRequest> Requests, FComponentSweepBatchResults& OutResults, int32 MaxHitsPerRequest = 16);
+};
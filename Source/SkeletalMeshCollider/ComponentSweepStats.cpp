@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ComponentSweepStats.h"
+
+DEFINE_STAT(STAT_ComponentSweep_Pose);
+DEFINE_STAT(STAT_ComponentSweep_ShapeSetup);
+DEFINE_STAT(STAT_ComponentSweep_SceneQuery);
+DEFINE_STAT(STAT_ComponentSweep_Finalize);
+DEFINE_STAT(STAT_ComponentSweep_NumSweeps);
+DEFINE_STAT(STAT_ComponentSweep_NumBodies);
+DEFINE_STAT(STAT_ComponentSweep_NumShapes);
+DEFINE_STAT(STAT_ComponentSweep_NumCandidates);
+
+void FComponentSweepStats::Publish() const
+{
+	INC_DWORD_STAT(STAT_ComponentSweep_NumSweeps);
+	INC_DWORD_STAT_BY(STAT_ComponentSweep_NumBodies, NumBodies);
+	INC_DWORD_STAT_BY(STAT_ComponentSweep_NumShapes, NumShapes);
+	INC_DWORD_STAT_BY(STAT_ComponentSweep_NumCandidates, NumCandidates);
+}
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("ComponentSweep"), STATGROUP_ComponentSweep, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pose"), STAT_ComponentSweep_Pose, STATGROUP_ComponentSweep, SKELETALMESHCOLLIDER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Shape setup"), STAT_ComponentSweep_ShapeSetup, STATGROUP_ComponentSweep, SKELETALMESHCOLLIDER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scene query"), STAT_ComponentSweep_SceneQuery, STATGROUP_ComponentSweep, SKELETALMESHCOLLIDER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Finalize hits"), STAT_ComponentSweep_Finalize, STATGROUP_ComponentSweep, SKELETALMESHCOLLIDER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Sweeps"), STAT_ComponentSweep_NumSweeps, STATGROUP_ComponentSweep, SKELETALMESHCOLLIDER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Bodies tested"), STAT_ComponentSweep_NumBodies, STATGROUP_ComponentSweep, SKELETALMESHCOLLIDER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Shapes tested"), STAT_ComponentSweep_NumShapes, STATGROUP_ComponentSweep, SKELETALMESHCOLLIDER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Candidate hits"), STAT_ComponentSweep_NumCandidates, STATGROUP_ComponentSweep, SKELETALMESHCOLLIDER_API);
+
+/**
+ * Counters and phase times of the last sweep made through USkeletalMeshSweepSubsystem or FReusableComponentSweep.
+ *
+ * The same numbers are accumulated per frame into STATGROUP_ComponentSweep ("stat ComponentSweep"). The scene
+ * query does broadphase and narrowphase in one call, so its time covers both, and the candidates are the hits
+ * that the scene queries of all shapes returned before they were merged and truncated at the blocking hit.
+ */
+struct SKELETALMESHCOLLIDER_API FComponentSweepStats
+{
+	int32 NumBodies = 0;
+	int32 NumShapes = 0;
+	int32 NumCandidates = 0;
+	/** Hits left after merging. */
+	int32 NumHits = 0;
+	/** True if the collision LOD proxy was swept instead of the body shapes. */
+	bool bProxy = false;
+
+	/** Bringing the cached body shapes up to date with the pose. */
+	double PoseSeconds = 0.0;
+	/** Placing the shapes at the start of the sweep. */
+	double ShapeSetupSeconds = 0.0;
+	double SceneQuerySeconds = 0.0;
+	/** Sorting the hits and truncating them at the blocking hit. */
+	double FinalizeSeconds = 0.0;
+
+	void Reset() { *this = FComponentSweepStats(); }
+
+	/** Adds the counters to the stats of the current frame. */
+	void Publish() const;
+};
+
+/** Adds the time spent in its scope to one of the phase times of FComponentSweepStats. */
+class FComponentSweepPhaseTimer
+{
+public:
+	explicit FComponentSweepPhaseTimer(double& InSeconds)
+		: Seconds(InSeconds)
+		, StartCycles(FPlatformTime::Cycles64())
+	{
+	}
+
+	~FComponentSweepPhaseTimer()
+	{
+		Seconds += FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+	}
+
+private:
+	double& Seconds;
+	uint64 StartCycles;
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ComponentWeldBatch.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+
+int32 FComponentWeldBatch::WeldTo(UPrimitiveComponent* Root, TArrayView<UPrimitiveComponent* const> Children)
+{
+	check(IsInGameThread());
+
+	if (!Root || !Root->GetBodyInstance(NAME_None, false))
+		return 0;
+
+	// Attaching while Root has no body doesn't weld anything yet; welding into any other parent would move the
+	// shapes of the child twice
+	const bool bRootHadPhysicsState = Root->IsPhysicsStateCreated();
+	if (bRootHadPhysicsState)
+		Root->DestroyPhysicsState();
+
+	for (UPrimitiveComponent* Child : Children)
+	{
+		if (!Child || Child == Root)
+			continue;
+
+		if (Child->IsWelded() && Child->GetAttachParent() != Root)
+			Child->UnWeldFromParent();
+		if (Child->GetAttachParent() != Root)
+			Child->AttachToComponent(Root, FAttachmentTransformRules(EAttachmentRule::KeepWorld, false));
+		Child->BodyInstance.bAutoWeld = true;
+	}
+
+	if (bRootHadPhysicsState)
+		Root->CreatePhysicsState();
+
+	FBodyInstance* RootBodyInstance = Root->GetBodyInstance(NAME_None, false);
+	int32 NumWelded = 0;
+	for (UPrimitiveComponent* Child : Children)
+	{
+		FBodyInstance* ChildBodyInstance = (Child && Child != Root) ? Child->GetBodyInstance(NAME_None, false) : nullptr;
+		if (!ChildBodyInstance)
+			continue;
+
+		if (ChildBodyInstance->WeldParent != RootBodyInstance)
+			Child->WeldTo(Root);
+
+		if (ChildBodyInstance->WeldParent == RootBodyInstance)
+			NumWelded++;
+	}
+
+	return NumWelded;
+}
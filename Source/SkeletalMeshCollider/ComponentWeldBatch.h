@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPrimitiveComponent;
+
+class SKELETALMESHCOLLIDER_API FComponentWeldBatch
+{
+public:
+	/**
+	 * Welds every component in Children to Root, attaching it first (keeping its world transform) if needed, and
+	 * rebuilds the body of Root once for the whole set.
+	 *
+	 * UPrimitiveComponent::WeldTo updates the mass and filters of the root over all of its shapes on every call, so
+	 * welding N children one by one costs O(N^2). Here the physics state of Root is torn down, every child is
+	 * attached with auto weld, and recreating the physics state of Root welds them in one pass. A child the engine
+	 * did not weld while creating the body is welded afterwards on its own. Returns the number of children welded
+	 * to Root. Game thread only.
+	 */
+	static int32 WeldTo(UPrimitiveComponent* Root, TArrayView<UPrimitiveComponent* const> Children);
+};
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DeferredPhysicsStateSubsystem.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+void UDeferredPhysicsStateSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UDeferredPhysicsStateSubsystem::OnWorldTickStart);
+}
+
+void UDeferredPhysicsStateSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+	DeferredComponents.Empty();
+	Super::Deinitialize();
+}
+
+AActor* UDeferredPhysicsStateSubsystem::SpawnActor(UClass* Class, const FTransform& Transform)
+{
+	UWorld* World = GetWorld();
+	if (!World || !Class)
+		return nullptr;
+
+	AActor* Actor = World->SpawnActorDeferred<AActor>(Class, Transform);
+	if (!Actor)
+		return nullptr;
+
+	TInlineComponentArray<USkeletalMeshComponent*> Components(Actor);
+	for (USkeletalMeshComponent* Component : Components)
+		DeferPhysicsState(*Component);
+
+	Actor->FinishSpawning(Transform);
+	return Actor;
+}
+
+bool UDeferredPhysicsStateSubsystem::DeferPhysicsState(USkeletalMeshComponent& Component)
+{
+	if (Component.IsRegistered() || Component.BodyInstance.bSimulatePhysics || !Component.IsCollisionEnabled() || DeferredComponents.Contains(&Component))
+		return false;
+
+	DeferredComponents.Add(&Component, Component.GetCollisionEnabled());
+	Component.SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	return true;
+}
+
+bool UDeferredPhysicsStateSubsystem::CreateDeferredPhysicsState(USkeletalMeshComponent& Component)
+{
+	TEnumAsByte<ECollisionEnabled::Type> CollisionEnabled;
+	if (!DeferredComponents.RemoveAndCopyValue(&Component, CollisionEnabled))
+		return false;
+
+	RestorePhysicsState(Component, CollisionEnabled);
+	return true;
+}
+
+bool UDeferredPhysicsStateSubsystem::IsPhysicsStateDeferred(const USkeletalMeshComponent& Component) const
+{
+	return DeferredComponents.Contains(const_cast<USkeletalMeshComponent*>(&Component));
+}
+
+int32 UDeferredPhysicsStateSubsystem::PrewarmDeferredPhysicsStates(double BudgetSeconds)
+{
+	if (BudgetSeconds <= 0.0)
+		return 0;
+
+	const double EndSeconds = FPlatformTime::Seconds() + BudgetSeconds;
+	int32 NumCreated = 0;
+	for (auto It = DeferredComponents.CreateIterator(); It; ++It)
+	{
+		USkeletalMeshComponent* Component = It.Key().Get();
+		const ECollisionEnabled::Type CollisionEnabled = It.Value();
+		It.RemoveCurrent();
+
+		// Components destroyed while deferred just leave the map
+		if (!Component)
+			continue;
+
+		RestorePhysicsState(*Component, CollisionEnabled);
+		NumCreated++;
+
+		if (FPlatformTime::Seconds() >= EndSeconds)
+			break;
+	}
+
+	return NumCreated;
+}
+
+void UDeferredPhysicsStateSubsystem::RestorePhysicsState(USkeletalMeshComponent& Component, ECollisionEnabled::Type CollisionEnabled)
+{
+	Component.SetCollisionEnabled(CollisionEnabled);
+	if (Component.IsRegistered() && !Component.IsPhysicsStateCreated())
+		Component.RecreatePhysicsState();
+}
+
+void UDeferredPhysicsStateSubsystem::OnWorldTickStart(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (TickedWorld == GetWorld() && DeferredComponents.Num() > 0)
+		PrewarmDeferredPhysicsStates(PrewarmBudgetSeconds);
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DeferredPhysicsStateSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ * Opt-in lazy physics state for skeletal mesh components, so that spawning crowds in bursts doesn't create every
+ * body of every physics asset in the frame of the spawn.
+ *
+ * A deferred component registers with its collision switched off, which keeps it from creating its physics state.
+ * The collision it had is restored, and the bodies are created, the first time the component is swept through
+ * USkeletalMeshSweepSubsystem or UAsyncComponentSweepSubsystem, when CreateDeferredPhysicsState is called, or when
+ * the time-sliced prewarm at the start of every tick of the world gets to it. Until then engine queries don't see
+ * the component. Components that simulate physics are never deferred, since the next physics step needs them.
+ */
+UCLASS()
+class SKELETALMESHCOLLIDER_API UDeferredPhysicsStateSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * UWorld::SpawnActor, except that the skeletal mesh components the actor has before its construction script
+	 * runs, such as that of ASkeletalMeshActor, have their physics state deferred.
+	 */
+	AActor* SpawnActor(UClass* Class, const FTransform& Transform = FTransform::Identity);
+
+	template <class T>
+	T* SpawnActor(UClass* Class, const FTransform& Transform = FTransform::Identity)
+	{
+		return Cast<T>(SpawnActor(Class, Transform));
+	}
+
+	/** Keeps Component, which must not be registered yet, from creating its physics state when it registers. */
+	bool DeferPhysicsState(USkeletalMeshComponent& Component);
+
+	/** Restores the collision of Component and creates its physics state, if they were deferred. */
+	bool CreateDeferredPhysicsState(USkeletalMeshComponent& Component);
+
+	bool IsPhysicsStateDeferred(const USkeletalMeshComponent& Component) const;
+	int32 GetNumDeferred() const { return DeferredComponents.Num(); }
+
+	/**
+	 * Creates deferred physics states until BudgetSeconds have passed, and at least one if BudgetSeconds is
+	 * positive; returns how many were created.
+	 */
+	int32 PrewarmDeferredPhysicsStates(double BudgetSeconds);
+
+	/** Time given to PrewarmDeferredPhysicsStates at the start of every tick of the world; 0 turns prewarming off. */
+	void SetPrewarmBudget(double Seconds) { PrewarmBudgetSeconds = FMath::Max(Seconds, 0.0); }
+	double GetPrewarmBudget() const { return PrewarmBudgetSeconds; }
+
+private:
+	static void RestorePhysicsState(USkeletalMeshComponent& Component, ECollisionEnabled::Type CollisionEnabled);
+	void OnWorldTickStart(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds);
+
+	/** Collision of every deferred component before it was switched off. */
+	TMap<TWeakObjectPtr<USkeletalMeshComponent>, TEnumAsByte<ECollisionEnabled::Type>> DeferredComponents;
+	double PrewarmBudgetSeconds = 0.001;
+	FDelegateHandle TickStartHandle;
+};
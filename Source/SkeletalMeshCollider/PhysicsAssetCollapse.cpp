@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PhysicsAssetCollapse.h"
+
+#include "Engine/SkeletalMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/PhysicsConstraintTemplate.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "SkeletalMeshRefPoseData.h"
+
+bool FPhysicsAssetCollapse::CanCollapse(const USkeletalMesh& SkeletalMesh, const UPhysicsAsset& PhysicsAsset, bool bNeverAnimates)
+{
+	if (!bNeverAnimates)
+		return false;
+
+	// A single body moves with the component whether it simulates or not, but several default bodies may simulate apart
+	const bool bMultipleBodies = PhysicsAsset.SkeletalBodySetups.Num() > 1;
+	for (const USkeletalBodySetup* BodySetup : PhysicsAsset.SkeletalBodySetups)
+	{
+		if (!BodySetup)
+			continue;
+
+		if (BodySetup->PhysicsType == EPhysicsType::PhysType_Simulated
+			|| (BodySetup->PhysicsType == EPhysicsType::PhysType_Default && bMultipleBodies)
+			|| BodySetup->AggGeom.TaperedCapsuleElems.Num() > 0)
+			return false;
+	}
+
+	for (const UPhysicsConstraintTemplate* Constraint : PhysicsAsset.ConstraintSetup)
+	{
+		if (!Constraint)
+			continue;
+
+		const FConstraintInstance& Instance = Constraint->DefaultInstance;
+		if (Instance.GetLinearXMotion() != ELinearConstraintMotion::LCM_Locked
+			|| Instance.GetLinearYMotion() != ELinearConstraintMotion::LCM_Locked
+			|| Instance.GetLinearZMotion() != ELinearConstraintMotion::LCM_Locked
+			|| Instance.GetAngularSwing1Motion() != EAngularConstraintMotion::ACM_Locked
+			|| Instance.GetAngularSwing2Motion() != EAngularConstraintMotion::ACM_Locked
+			|| Instance.GetAngularTwistMotion() != EAngularConstraintMotion::ACM_Locked)
+			return false;
+	}
+
+	return SkeletalMesh.GetRefSkeleton().GetNum() > 0;
+}
+
+bool FPhysicsAssetCollapse::Bake(const USkeletalMesh& SkeletalMesh, const UPhysicsAsset& PhysicsAsset, bool bNeverAnimates, FKAggregateGeom& OutAggGeom)
+{
+	OutAggGeom.EmptyElements();
+	if (!CanCollapse(SkeletalMesh, PhysicsAsset, bNeverAnimates))
+		return false;
+
+	TArray<FTransform> ComponentSpaceTransforms;
+	GetRefPoseComponentSpaceTransforms(SkeletalMesh, ComponentSpaceTransforms);
+
+	for (const USkeletalBodySetup* BodySetup : PhysicsAsset.SkeletalBodySetups)
+	{
+		const int32 BoneIndex = BodySetup ? SkeletalMesh.GetRefSkeleton().FindBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+		if (BoneIndex == INDEX_NONE)
+			continue;
+
+		// Scale is applied to the element extents in bone space, like FSkeletalMeshBodyShapeCache does
+		FTransform BoneToComponent = ComponentSpaceTransforms[BoneIndex];
+		const FVector Scale3D = BoneToComponent.GetScale3D();
+		const FVector Scale3DAbs = Scale3D.GetAbs();
+		BoneToComponent.RemoveScaling();
+
+		auto ToComponent = [&](const FQuat& ElemRotation, const FVector& ElemCenter)
+		{
+			return FTransform(ElemRotation, ElemCenter * Scale3D) * BoneToComponent;
+		};
+
+		const FKAggregateGeom& AggGeom = BodySetup->AggGeom;
+		for (const FKSphereElem& Elem : AggGeom.SphereElems)
+		{
+			FKSphereElem& Baked = OutAggGeom.SphereElems.Add_GetRef(Elem);
+			Baked.Center = ToComponent(FQuat::Identity, Elem.Center).GetLocation();
+			Baked.Radius = Elem.Radius * Scale3DAbs.GetMin();
+		}
+
+		for (const FKBoxElem& Elem : AggGeom.BoxElems)
+		{
+			const FTransform ElemToComponent = ToComponent(Elem.Rotation.Quaternion(), Elem.Center);
+			FKBoxElem& Baked = OutAggGeom.BoxElems.Add_GetRef(Elem);
+			Baked.Center = ElemToComponent.GetLocation();
+			Baked.Rotation = ElemToComponent.Rotator();
+			Baked.X = Elem.X * Scale3DAbs.X;
+			Baked.Y = Elem.Y * Scale3DAbs.Y;
+			Baked.Z = Elem.Z * Scale3DAbs.Z;
+		}
+
+		for (const FKSphylElem& Elem : AggGeom.SphylElems)
+		{
+			const FTransform ElemToComponent = ToComponent(Elem.Rotation.Quaternion(), Elem.Center);
+			FKSphylElem& Baked = OutAggGeom.SphylElems.Add_GetRef(Elem);
+			Baked.Center = ElemToComponent.GetLocation();
+			Baked.Rotation = ElemToComponent.Rotator();
+			Baked.Radius = Elem.Radius * FMath::Max(Scale3DAbs.X, Scale3DAbs.Y);
+			Baked.Length = Elem.Length * Scale3DAbs.Z;
+		}
+
+		// Convex hulls take any scale exactly, so their vertices are moved into component space
+		for (const FKConvexElem& Elem : AggGeom.ConvexElems)
+		{
+			const FTransform ElemTransform = Elem.GetTransform();
+			FKConvexElem& Baked = OutAggGeom.ConvexElems.Add_GetRef(Elem);
+			Baked.SetTransform(FTransform::Identity);
+			for (FVector& Vertex : Baked.VertexData)
+				Vertex = BoneToComponent.TransformPosition(ElemTransform.TransformPosition(Vertex) * Scale3D);
+			Baked.UpdateElemBox();
+		}
+	}
+
+	return OutAggGeom.GetElementCount() > 0;
+}
+
+void FPhysicsAssetCollapse::GetRefPoseComponentSpaceTransforms(const USkeletalMesh& SkeletalMesh, TArray<FTransform>& OutTransforms)
+{
+	if (const USkeletalMeshRefPoseData* RefPoseData = USkeletalMeshRefPoseData::Find(SkeletalMesh))
+		OutTransforms = RefPoseData->ComponentSpaceRefPose;
+	else
+		USkeletalMeshRefPoseData::ComposeComponentSpaceRefPose(SkeletalMesh.GetRefSkeleton(), OutTransforms);
+}
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPhysicsAsset;
+class USkeletalMesh;
+struct FKAggregateGeom;
+
+/**
+ * Collapses the bodies of a physics asset into one component space aggregate geometry, with the ref pose of the
+ * skeletal mesh, including its rotations and scales, applied to every element.
+ */
+class SKELETALMESHCOLLIDER_API FPhysicsAssetCollapse
+{
+public:
+	/**
+	 * True when the bodies can never move relative to each other: the caller vouches with bNeverAnimates that
+	 * nothing poses the mesh away from its ref pose, which the assets alone can't tell, no body is simulated, nor
+	 * left to the simulation setting of the component when there is more than one, every constraint locks all six
+	 * degrees of freedom, and no body uses tapered capsules, which have no scene query support.
+	 */
+	static bool CanCollapse(const USkeletalMesh& SkeletalMesh, const UPhysicsAsset& PhysicsAsset, bool bNeverAnimates);
+
+	/**
+	 * Replaces the elements of OutAggGeom with those of every body whose bone exists in SkeletalMesh, in component
+	 * space. Spheres and capsules under non-uniform scale get the same approximation the engine uses for bodies.
+	 * Returns false, leaving OutAggGeom empty, when the physics asset can't be collapsed.
+	 */
+	static bool Bake(const USkeletalMesh& SkeletalMesh, const UPhysicsAsset& PhysicsAsset, bool bNeverAnimates, FKAggregateGeom& OutAggGeom);
+
+	/** Component space transforms of the ref pose of SkeletalMesh, from USkeletalMeshRefPoseData when it was baked. */
+	static void GetRefPoseComponentSpaceTransforms(const USkeletalMesh& SkeletalMesh, TArray<FTransform>& OutTransforms);
+};
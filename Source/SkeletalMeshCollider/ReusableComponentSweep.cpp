@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ReusableComponentSweep.h"
+
+#include "Components/ShapeComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+namespace
+{
+	bool HasWeldedChildren(const UPrimitiveComponent& Component)
+	{
+		for (const USceneComponent* Child : Component.GetAttachChildren())
+		{
+			const UPrimitiveComponent* PrimitiveChild = Cast<UPrimitiveComponent>(Child);
+			if (PrimitiveChild && PrimitiveChild->GetBodyInstance(NAME_None, false) && PrimitiveChild->GetBodyInstance(NAME_None, false)->WeldParent)
+				return true;
+		}
+		return false;
+	}
+
+	/** Skeletal mesh sweeps are recorded by the subsystem itself. */
+	void CaptureSweep(UWorld& World, const UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, TArrayView<const FHitResult> Hits)
+	{
+		const USkeletalMeshSweepSubsystem* Subsystem = World.GetSubsystem<USkeletalMeshSweepSubsystem>();
+		if (FSweepCaptureWriter* SweepCapture = Subsystem ? Subsystem->GetSweepCapture() : nullptr)
+			SweepCapture->RecordComponentSweep(Component, Start, End, Rot, Params, Hits);
+	}
+}
+
+FReusableComponentSweep::FReusableComponentSweep(int32 ExpectedNumHits)
+{
+	ScratchHits.Reserve(ExpectedNumHits);
+}
+
+void FReusableComponentSweep::SetIgnoredActors(TArrayView<const AActor* const> Actors)
+{
+	Params.ClearIgnoredActors();
+	for (const AActor* Actor : Actors)
+		Params.AddIgnoredActor(Actor);
+}
+
+bool FReusableComponentSweep::SweepIntoScratchHits(UWorld* World, UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot)
+{
+	ScratchHits.Reset();
+	LastSweepStats.Reset();
+	if (!World || !Component)
+		return false;
+
+	if (USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(Component))
+	{
+		if (USkeletalMeshSweepSubsystem* Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>())
+		{
+			const bool bBlockingHit = Subsystem->ComponentSweepMulti(ScratchHits, SkeletalMeshComponent, Start, End, Rot, Params);
+			LastSweepStats = Subsystem->GetLastSweepStats();
+			return bBlockingHit;
+		}
+	}
+	else if (Component->IsA<UShapeComponent>() && !HasWeldedChildren(*Component))
+	{
+		if (!Component->IsQueryCollisionEnabled())
+			return false;
+
+		LastSweepStats.NumBodies = 1;
+		LastSweepStats.NumShapes = 1;
+		bool bBlockingHit = false;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_ComponentSweep_SceneQuery);
+			FComponentSweepPhaseTimer PhaseTimer(LastSweepStats.SceneQuerySeconds);
+			const FCollisionResponseParams ResponseParams(Component->GetCollisionResponseToChannels());
+			bBlockingHit = World->SweepMultiByChannel(ScratchHits, Start, End, Rot, Component->GetCollisionObjectType(), Component->GetCollisionShape(), Params, ResponseParams);
+		}
+		LastSweepStats.NumCandidates = LastSweepStats.NumHits = ScratchHits.Num();
+		LastSweepStats.Publish();
+		CaptureSweep(*World, Component, Start, End, Rot, Params, ScratchHits);
+		return bBlockingHit;
+	}
+
+	// UWorld::ComponentSweepMulti sweeps every shape of the body instance, including those of welded children
+	if (const FBodyInstance* BodyInstance = Component->GetBodyInstance())
+	{
+		FPhysicsCommand::ExecuteRead(BodyInstance->ActorHandle, [&](const FPhysicsActorHandle& Actor)
+			{
+				LastSweepStats.NumShapes = BodyInstance->GetAllShapes_AssumesLocked(ScratchShapes);
+			});
+		LastSweepStats.NumBodies = LastSweepStats.NumShapes > 0 ? 1 : 0;
+	}
+
+	bool bBlockingHit = false;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ComponentSweep_SceneQuery);
+		FComponentSweepPhaseTimer PhaseTimer(LastSweepStats.SceneQuerySeconds);
+		bBlockingHit = World->ComponentSweepMulti(ScratchHits, Component, Start, End, Rot, Params);
+	}
+	LastSweepStats.NumCandidates = LastSweepStats.NumHits = ScratchHits.Num();
+	LastSweepStats.Publish();
+	CaptureSweep(*World, Component, Start, End, Rot, Params, ScratchHits);
+	return bBlockingHit;
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "ComponentSweepStats.h"
+#include "Engine/EngineTypes.h"
+#include "Physics/PhysicsInterfaceCore.h"
+
+class AActor;
+class UPrimitiveComponent;
+class UWorld;
+
+/** Caller owned hit buffer for FReusableComponentSweep; sweeps with up to 16 hits do not touch the heap. */
+using FComponentSweepHitBuffer = TArray<FHitResult, TInlineAllocator<16>>;
+
+/**
+ * ComponentSweepMulti that does not allocate once it has warmed up.
+ *
+ * The query params are built once and only modified in place, and the engine writes its hits into a scratch
+ * array that keeps its capacity from sweep to sweep. Skeletal mesh components are swept through
+ * USkeletalMeshSweepSubsystem, and box, sphere and capsule components without welded children as a single
+ * FCollisionShape, which both avoid the temporary hit arrays that UWorld::ComponentSweepMulti creates for
+ * every shape. Other components fall back to UWorld::ComponentSweepMulti.
+ *
+ * Not thread safe; use one instance per thread. Skeletal mesh components can only be swept on the game thread,
+ * like USkeletalMeshSweepSubsystem.
+ */
+class SKELETALMESHCOLLIDER_API FReusableComponentSweep
+{
+public:
+	explicit FReusableComponentSweep(int32 ExpectedNumHits = 16);
+
+	/** Replaces the ignored actors, reusing the storage of the previous ones. */
+	void SetIgnoredActors(TArrayView<const AActor* const> Actors);
+
+	FComponentQueryParams& GetParams() { return Params; }
+
+	/** Counters and phase times of the last sweep, whichever way it was routed. */
+	const FComponentSweepStats& GetLastSweepStats() const { return LastSweepStats; }
+
+	/** Same contract as UWorld::ComponentSweepMulti, with the hits copied into OutHits. */
+	template <uint32 NumInlineHits>
+	bool Sweep(UWorld* World, UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, TArray<FHitResult, TInlineAllocator<NumInlineHits>>& OutHits)
+	{
+		const bool bBlockingHit = SweepIntoScratchHits(World, Component, Start, End, Rot);
+		OutHits.Reset();
+		OutHits.Append(ScratchHits);
+		return bBlockingHit;
+	}
+
+private:
+	bool SweepIntoScratchHits(UWorld* World, UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot);
+
+	FComponentQueryParams Params;
+	TArray<FHitResult> ScratchHits;
+	TArray<FPhysicsShapeHandle> ScratchShapes;
+	FComponentSweepStats LastSweepStats;
+};
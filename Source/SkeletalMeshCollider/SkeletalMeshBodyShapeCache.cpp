@@ -0,0 +1,322 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkeletalMeshBodyShapeCache.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "SkeletalMeshBodyTree.h"
+
+namespace
+{
+	const float ScaleQuantum = 1.f / 8192.f;
+
+	uint32 HashTransform(const FTransform& Transform, uint32 Hash)
+	{
+		const FVector Translation = Transform.GetTranslation();
+		const FQuat Rotation = Transform.GetRotation();
+		const FVector Scale3D = Transform.GetScale3D();
+		const float Values[] = {
+			Translation.X, Translation.Y, Translation.Z,
+			Rotation.X, Rotation.Y, Rotation.Z, Rotation.W,
+			Scale3D.X, Scale3D.Y, Scale3D.Z
+		};
+		return FCrc::MemCrc32(Values, sizeof(Values), Hash);
+	}
+
+	FBox CalcBodyBounds(const FSharedBodyShapes& Shared, int32 BodyEntry)
+	{
+		const int32 EndShape = Shared.BodyFirstShapes.IsValidIndex(BodyEntry + 1) ? Shared.BodyFirstShapes[BodyEntry + 1] : Shared.Shapes.Num();
+		FBox Bounds(ForceInit);
+		for (int32 ShapeIndex = Shared.BodyFirstShapes[BodyEntry]; ShapeIndex < EndShape; ShapeIndex++)
+		{
+			const FCachedBodyShape& CachedShape = Shared.Shapes[ShapeIndex];
+			Bounds += FBox::BuildAABB(CachedShape.ShapeToComponent.GetLocation(), FSkeletalMeshBodyTree::GetShapeBoundsExtent(CachedShape.Shape, CachedShape.ShapeToComponent.GetRotation()));
+		}
+		return Bounds;
+	}
+
+	/** The shapes already carry the component scale, so only its rotation and translation remain. */
+	FTransform GetComponentToWorld(const USkeletalMeshComponent& Component)
+	{
+		return FTransform(Component.GetComponentQuat(), Component.GetComponentLocation());
+	}
+
+	/** Calls Function(Shape, ShapeToComponent) for every element of BodySetup, always in the same order. */
+	template <typename FunctionType>
+	void ForEachBodyShape(const UBodySetup& BodySetup, const FTransform& BoneTransform, const FVector& ComponentScale, FunctionType&& Function)
+	{
+		// Scale is applied to the element extents in bone space, the same way the engine scales body shapes
+		FTransform BoneToComponent = BoneTransform * FTransform(FQuat::Identity, FVector::ZeroVector, ComponentScale);
+		const FVector Scale3D = BoneToComponent.GetScale3D();
+		const FVector Scale3DAbs = Scale3D.GetAbs();
+		BoneToComponent.RemoveScaling();
+
+		const FKAggregateGeom& AggGeom = BodySetup.AggGeom;
+		for (const FKSphereElem& Elem : AggGeom.SphereElems)
+			Function(FCollisionShape::MakeSphere(Elem.Radius * Scale3DAbs.GetMin()), FTransform(FQuat::Identity, Elem.Center * Scale3D) * BoneToComponent);
+
+		for (const FKBoxElem& Elem : AggGeom.BoxElems)
+			Function(FCollisionShape::MakeBox(FVector{ Elem.X, Elem.Y, Elem.Z } * 0.5f * Scale3DAbs), FTransform(Elem.Rotation.Quaternion(), Elem.Center * Scale3D) * BoneToComponent);
+
+		for (const FKSphylElem& Elem : AggGeom.SphylElems)
+		{
+			const float Radius = Elem.Radius * FMath::Max(Scale3DAbs.X, Scale3DAbs.Y);
+			Function(FCollisionShape::MakeCapsule(Radius, Elem.Length * 0.5f * Scale3DAbs.Z + Radius), FTransform(Elem.Rotation.Quaternion(), Elem.Center * Scale3D) * BoneToComponent);
+		}
+	}
+}
+
+bool FSharedBodyShapes::Matches(const USkeletalMeshComponent& Component, const FIntVector& ComponentQuantizedScale) const
+{
+	if (SkeletalMesh.Get() != Component.SkeletalMesh
+		|| PhysicsAsset.Get() != Component.GetPhysicsAsset()
+		|| QuantizedScale != ComponentQuantizedScale)
+		return false;
+
+	const TArray<FTransform>& ComponentSpaceTransforms = Component.GetComponentSpaceTransforms();
+	for (int32 Index = 0; Index < BodyBoneIndices.Num(); Index++)
+	{
+		const int32 BoneIndex = BodyBoneIndices[Index];
+		if (!ComponentSpaceTransforms.IsValidIndex(BoneIndex) || !ComponentSpaceTransforms[BoneIndex].Equals(BodyBoneTransforms[Index], 0.f))
+			return false;
+	}
+
+	return true;
+}
+
+void FSharedBodyShapes::SetBodyBoneTransform(int32 BodyEntry, const FTransform& BoneTransform)
+{
+	BodyBoneTransforms[BodyEntry] = BoneTransform;
+
+	const UPhysicsAsset* Asset = PhysicsAsset.Get();
+	const USkeletalBodySetup* BodySetup = Asset && Asset->SkeletalBodySetups.IsValidIndex(BodyIndices[BodyEntry]) ? Asset->SkeletalBodySetups[BodyIndices[BodyEntry]] : nullptr;
+	if (!BodySetup)
+		return;
+
+	int32 ShapeIndex = BodyFirstShapes[BodyEntry];
+	ForEachBodyShape(*BodySetup, BoneTransform, FSharedBodyShapesRegistry::DequantizeScale(QuantizedScale), [this, &ShapeIndex](const FCollisionShape& Shape, const FTransform& ShapeToComponent)
+		{
+			Shapes[ShapeIndex].Shape = Shape;
+			Shapes[ShapeIndex].ShapeToComponent = ShapeToComponent;
+			ShapeIndex++;
+		});
+	BodyBounds[BodyEntry] = CalcBodyBounds(*this, BodyEntry);
+}
+
+SIZE_T FSharedBodyShapes::GetAllocatedSize() const
+{
+	return BodyIndices.GetAllocatedSize() + BodyBoneIndices.GetAllocatedSize() + BodyBoneTransforms.GetAllocatedSize() + BodyFirstShapes.GetAllocatedSize() + Shapes.GetAllocatedSize() + BodyBounds.GetAllocatedSize();
+}
+
+FSharedBodyShapesRegistry& FSharedBodyShapesRegistry::Get()
+{
+	static FSharedBodyShapesRegistry Registry;
+	return Registry;
+}
+
+TSharedRef<const FSharedBodyShapes> FSharedBodyShapesRegistry::FindOrBuild(const USkeletalMeshComponent& Component)
+{
+	check(IsInGameThread());
+
+	const FIntVector QuantizedScale = QuantizeScale(Component.GetComponentScale());
+	const uint32 KeyHash = GetKeyHash(Component, QuantizedScale);
+	for (auto It = Entries.CreateKeyIterator(KeyHash); It; ++It)
+	{
+		TSharedPtr<const FSharedBodyShapes> Shapes = It.Value().Pin();
+		if (Shapes.IsValid() && Shapes->Matches(Component, QuantizedScale))
+			return Shapes.ToSharedRef();
+	}
+
+	if (Entries.Num() >= NextStaleEntryPruneNum)
+	{
+		for (auto It = Entries.CreateIterator(); It; ++It)
+			if (!It.Value().IsValid())
+				It.RemoveCurrent();
+		NextStaleEntryPruneNum = FMath::Max(Entries.Num() * 2, 64);
+	}
+
+	TSharedRef<FSharedBodyShapes> Shapes = Build(Component, QuantizedScale);
+	Entries.Add(KeyHash, Shapes);
+	return Shapes;
+}
+
+int32 FSharedBodyShapesRegistry::GetNumShared() const
+{
+	int32 NumShared = 0;
+	for (const auto& Entry : Entries)
+		if (Entry.Value.IsValid())
+			NumShared++;
+	return NumShared;
+}
+
+SIZE_T FSharedBodyShapesRegistry::GetSharedAllocatedSize() const
+{
+	SIZE_T AllocatedSize = 0;
+	for (const auto& Entry : Entries)
+		if (TSharedPtr<const FSharedBodyShapes> Shapes = Entry.Value.Pin())
+			AllocatedSize += sizeof(FSharedBodyShapes) + Shapes->GetAllocatedSize();
+	return AllocatedSize;
+}
+
+FIntVector FSharedBodyShapesRegistry::QuantizeScale(const FVector& Scale)
+{
+	return FIntVector(FMath::RoundToInt(Scale.X / ScaleQuantum), FMath::RoundToInt(Scale.Y / ScaleQuantum), FMath::RoundToInt(Scale.Z / ScaleQuantum));
+}
+
+FVector FSharedBodyShapesRegistry::DequantizeScale(const FIntVector& QuantizedScale)
+{
+	return FVector(QuantizedScale.X, QuantizedScale.Y, QuantizedScale.Z) * ScaleQuantum;
+}
+
+uint32 FSharedBodyShapesRegistry::GetKeyHash(const USkeletalMeshComponent& Component, const FIntVector& QuantizedScale)
+{
+	uint32 Hash = HashCombine(PointerHash(Component.SkeletalMesh), PointerHash(Component.GetPhysicsAsset()));
+	Hash = FCrc::MemCrc32(&QuantizedScale, sizeof(QuantizedScale), Hash);
+
+	const UPhysicsAsset* PhysicsAsset = Component.GetPhysicsAsset();
+	if (!PhysicsAsset)
+		return Hash;
+
+	const TArray<FTransform>& ComponentSpaceTransforms = Component.GetComponentSpaceTransforms();
+	for (const USkeletalBodySetup* BodySetup : PhysicsAsset->SkeletalBodySetups)
+	{
+		const int32 BoneIndex = BodySetup ? Component.GetBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+		if (ComponentSpaceTransforms.IsValidIndex(BoneIndex))
+			Hash = HashTransform(ComponentSpaceTransforms[BoneIndex], Hash);
+	}
+	return Hash;
+}
+
+TSharedRef<FSharedBodyShapes> FSharedBodyShapesRegistry::Build(const USkeletalMeshComponent& Component, const FIntVector& QuantizedScale)
+{
+	TSharedRef<FSharedBodyShapes> Shared = MakeShared<FSharedBodyShapes>();
+	Shared->SkeletalMesh = Component.SkeletalMesh;
+	Shared->PhysicsAsset = Component.GetPhysicsAsset();
+	Shared->QuantizedScale = QuantizedScale;
+	Shared->bSupported = Shared->PhysicsAsset.IsValid();
+
+	if (!Shared->bSupported)
+		return Shared;
+
+	// Built from the quantized scale, so the shapes don't depend on which instance happened to build them
+	const FVector ComponentScale = DequantizeScale(QuantizedScale);
+	const TArray<FTransform>& ComponentSpaceTransforms = Component.GetComponentSpaceTransforms();
+	const TArray<USkeletalBodySetup*>& BodySetups = Shared->PhysicsAsset->SkeletalBodySetups;
+	for (int32 BodyIndex = 0; BodyIndex < BodySetups.Num(); BodyIndex++)
+	{
+		const USkeletalBodySetup* BodySetup = BodySetups[BodyIndex];
+		const int32 BoneIndex = BodySetup ? Component.GetBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+		if (!ComponentSpaceTransforms.IsValidIndex(BoneIndex))
+			continue;
+
+		Shared->BodyIndices.Add(BodyIndex);
+		Shared->BodyBoneIndices.Add(BoneIndex);
+		Shared->BodyBoneTransforms.Add(ComponentSpaceTransforms[BoneIndex]);
+		Shared->BodyFirstShapes.Add(Shared->Shapes.Num());
+
+		const FKAggregateGeom& AggGeom = BodySetup->AggGeom;
+		if (AggGeom.ConvexElems.Num() > 0 || AggGeom.TaperedCapsuleElems.Num() > 0)
+			Shared->bSupported = false;
+
+		ForEachBodyShape(*BodySetup, ComponentSpaceTransforms[BoneIndex], ComponentScale, [&](const FCollisionShape& Shape, const FTransform& ShapeToComponent)
+			{
+				FCachedBodyShape& CachedShape = Shared->Shapes.AddDefaulted_GetRef();
+				CachedShape.Shape = Shape;
+				CachedShape.ShapeToComponent = ShapeToComponent;
+				CachedShape.BodyIndex = BodyIndex;
+				CachedShape.BoneName = BodySetup->BoneName;
+			});
+	}
+
+	Shared->Shapes.Shrink();
+	for (int32 BodyEntry = 0; BodyEntry < Shared->BodyFirstShapes.Num(); BodyEntry++)
+		Shared->BodyBounds.Add(CalcBodyBounds(*Shared, BodyEntry));
+	return Shared;
+}
+
+bool FSkeletalMeshBodyShapeCache::Update(const USkeletalMeshComponent& Component)
+{
+	const FTransform ComponentToWorld = GetComponentToWorld(Component);
+	const FIntVector QuantizedScale = FSharedBodyShapesRegistry::QuantizeScale(Component.GetComponentScale());
+	if (!Shared.IsValid()
+		|| Shared->SkeletalMesh.Get() != Component.SkeletalMesh
+		|| Shared->PhysicsAsset.Get() != Component.GetPhysicsAsset()
+		|| Shared->QuantizedScale != QuantizedScale)
+	{
+		Rebuild(Component);
+		UpdateAllBodyWorldBounds(ComponentToWorld);
+		return true;
+	}
+
+	// When the component has moved every body gets new world bounds anyway, after the shapes are up to date
+	const bool bComponentMoved = !ComponentToWorld.Equals(BoundsComponentToWorld, 0.f);
+
+	// Only bodies whose bone moved since the last update are composed again, so repeated sweeps of an unchanged
+	// pose, such as several in one frame, only pay for the comparison
+	const TArray<FTransform>& ComponentSpaceTransforms = Component.GetComponentSpaceTransforms();
+	bool bUpdated = false;
+	for (int32 BodyEntry = 0; BodyEntry < Shared->BodyBoneIndices.Num(); BodyEntry++)
+	{
+		const int32 BoneIndex = Shared->BodyBoneIndices[BodyEntry];
+		if (!ComponentSpaceTransforms.IsValidIndex(BoneIndex))
+		{
+			Rebuild(Component);
+			UpdateAllBodyWorldBounds(ComponentToWorld);
+			return true;
+		}
+
+		const FTransform& BoneTransform = ComponentSpaceTransforms[BoneIndex];
+		if (BoneTransform.Equals(Shared->BodyBoneTransforms[BodyEntry], 0.f))
+			continue;
+
+		// Shapes shared with other caches, or still held by an async sweep, are copied before they change
+		if (!bOwnsShapes || !Shared.IsUnique())
+		{
+			Shared = MakeShared<FSharedBodyShapes>(*Shared);
+			bOwnsShapes = true;
+		}
+		ConstCastSharedPtr<FSharedBodyShapes>(Shared)->SetBodyBoneTransform(BodyEntry, BoneTransform);
+		NumBodyUpdates++;
+		bUpdated = true;
+		if (!bComponentMoved)
+			UpdateBodyWorldBounds(BodyEntry);
+	}
+
+	if (bComponentMoved)
+		UpdateAllBodyWorldBounds(ComponentToWorld);
+	return bUpdated;
+}
+
+void FSkeletalMeshBodyShapeCache::Invalidate()
+{
+	Shared.Reset();
+	bOwnsShapes = false;
+}
+
+void FSkeletalMeshBodyShapeCache::UpdateBodyWorldBounds(int32 BodyEntry)
+{
+	BodyWorldBounds[BodyEntry] = Shared->BodyBounds[BodyEntry].TransformBy(BoundsComponentToWorld);
+	NumBodyBoundsUpdates++;
+}
+
+void FSkeletalMeshBodyShapeCache::UpdateAllBodyWorldBounds(const FTransform& ComponentToWorld)
+{
+	BoundsComponentToWorld = ComponentToWorld;
+	BodyWorldBounds.SetNum(Shared->BodyBounds.Num(), false);
+	for (int32 BodyEntry = 0; BodyEntry < BodyWorldBounds.Num(); BodyEntry++)
+		UpdateBodyWorldBounds(BodyEntry);
+}
+
+void FSkeletalMeshBodyShapeCache::Rebuild(const USkeletalMeshComponent& Component)
+{
+	NumRebuilds++;
+	Shared = FSharedBodyShapesRegistry::Get().FindOrBuild(Component);
+	bOwnsShapes = false;
+}
+
+const TArray<FCachedBodyShape>& FSkeletalMeshBodyShapeCache::GetShapes() const
+{
+	static const TArray<FCachedBodyShape> NoShapes;
+	return Shared.IsValid() ? Shared->Shapes : NoShapes;
+}
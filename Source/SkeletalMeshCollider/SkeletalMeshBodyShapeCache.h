@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionShape.h"
+
+class UPhysicsAsset;
+class USkeletalMesh;
+class USkeletalMeshComponent;
+
+/** One collision element of a physics asset body, placed in the scaled component space of its skeletal mesh component. */
+struct SKELETALMESHCOLLIDER_API FCachedBodyShape
+{
+	/** Shape with the bone scale and the component scale applied to its extents. */
+	FCollisionShape Shape;
+	/** Rotation and translation of the shape relative to the component; translation includes the component scale. */
+	FTransform ShapeToComponent;
+	int32 BodyIndex = INDEX_NONE;
+	FName BoneName;
+};
+
+/**
+ * Body shapes built for one skeletal mesh, physics asset, quantized component scale and pose of the bones that
+ * carry bodies. Immutable once built, and shared by every FSkeletalMeshBodyShapeCache that matches all four.
+ */
+struct SKELETALMESHCOLLIDER_API FSharedBodyShapes
+{
+	TWeakObjectPtr<const USkeletalMesh> SkeletalMesh;
+	TWeakObjectPtr<const UPhysicsAsset> PhysicsAsset;
+	FIntVector QuantizedScale = FIntVector::ZeroValue;
+	/** Physics asset body index, bone index, component space bone transform and first shape of every body entry. */
+	TArray<int32> BodyIndices;
+	TArray<int32> BodyBoneIndices;
+	TArray<FTransform> BodyBoneTransforms;
+	TArray<int32> BodyFirstShapes;
+
+	/** The shapes of a body entry are contiguous, and how many there are doesn't depend on the pose. */
+	TArray<FCachedBodyShape> Shapes;
+	/** Bounds of the shapes of every body entry, relative to the component like the shapes. */
+	TArray<FBox> BodyBounds;
+	bool bSupported = false;
+
+	/** True if the shapes were built for the mesh, physics asset, scale and body bone pose of Component. */
+	bool Matches(const USkeletalMeshComponent& Component, const FIntVector& ComponentQuantizedScale) const;
+
+	/** Moves the shapes of one body entry to a new bone transform, leaving the others untouched. */
+	void SetBodyBoneTransform(int32 BodyEntry, const FTransform& BoneTransform);
+
+	SIZE_T GetAllocatedSize() const;
+};
+
+/**
+ * Game thread registry of the FSharedBodyShapes in use, so that instances of the same skeletal mesh in the same
+ * pose at the same scale hold one copy of their scaled shapes instead of one each. Entries are owned by the
+ * caches that use them and disappear with the last of them.
+ */
+class SKELETALMESHCOLLIDER_API FSharedBodyShapesRegistry
+{
+public:
+	static FSharedBodyShapesRegistry& Get();
+
+	/** Returns the shapes matching Component, building them if no cache uses them yet. */
+	TSharedRef<const FSharedBodyShapes> FindOrBuild(const USkeletalMeshComponent& Component);
+
+	/** Number of shape sets currently in use. */
+	int32 GetNumShared() const;
+
+	/** Memory held by the shape sets currently in use. */
+	SIZE_T GetSharedAllocatedSize() const;
+
+	/**
+	 * Scale in steps of 1/8192: enough to keep the extents of a 1000 unit shape within a fraction of a unit, while
+	 * letting float noise from composed transforms map instances onto the same shapes.
+	 */
+	static FIntVector QuantizeScale(const FVector& Scale);
+	static FVector DequantizeScale(const FIntVector& QuantizedScale);
+
+private:
+	static TSharedRef<FSharedBodyShapes> Build(const USkeletalMeshComponent& Component, const FIntVector& QuantizedScale);
+	static uint32 GetKeyHash(const USkeletalMeshComponent& Component, const FIntVector& QuantizedScale);
+
+	TMultiMap<uint32, TWeakPtr<const FSharedBodyShapes>> Entries;
+	/** Entries whose shapes are gone are dropped when the map grows past this size. */
+	int32 NextStaleEntryPruneNum = 64;
+};
+
+/**
+ * Component space collision shapes of the physics asset bodies of a skeletal mesh component.
+ *
+ * Composing the bone transforms of the pose with the body elements is what makes sweeps of rotated and scaled
+ * ref poses more expensive than sweeps of a plain UBoxComponent. The cache does that composition once, and
+ * Update() only redoes it when the mesh, the physics asset or the quantized component scale has changed. The
+ * shapes come from FSharedBodyShapesRegistry; once the component animates away from them, the cache takes a
+ * private copy and recomposes only the bodies whose bone has moved since the previous update. The world bounds of
+ * every body follow the same way: only those of moved bodies are updated, unless the component itself has moved.
+ */
+class SKELETALMESHCOLLIDER_API FSkeletalMeshBodyShapeCache
+{
+public:
+	/** Brings the shapes up to date with the component; returns true if any of them changed. */
+	bool Update(const USkeletalMeshComponent& Component);
+
+	/** Drops the shapes, so that the next Update() rebuilds them. */
+	void Invalidate();
+
+	const TArray<FCachedBodyShape>& GetShapes() const;
+
+	/** Number of physics asset bodies whose bone exists in the skeletal mesh. */
+	int32 GetNumBodies() const { return Shared.IsValid() ? Shared->BodyBoneIndices.Num() : 0; }
+
+	/** False when a body uses elements that FCollisionShape cannot express (convex and tapered capsule elements). */
+	bool IsSupported() const { return Shared.IsValid() && Shared->bSupported; }
+
+	int32 GetNumRebuilds() const { return NumRebuilds; }
+
+	/** Number of times the shapes of a single body were recomposed for a new pose. */
+	int32 GetNumBodyUpdates() const { return NumBodyUpdates; }
+
+	/** The shapes, shared with every other cache of the same mesh, pose and scale. */
+	const TSharedPtr<const FSharedBodyShapes>& GetShared() const { return Shared; }
+
+	/** World bounds of the shapes of every body, in the order of the body entries of GetShared(); FSkeletalMeshBodyTree refits from them. */
+	const TArray<FBox>& GetBodyWorldBounds() const { return BodyWorldBounds; }
+
+	/** Number of times the world bounds of a single body were updated. */
+	int32 GetNumBodyBoundsUpdates() const { return NumBodyBoundsUpdates; }
+
+private:
+	void Rebuild(const USkeletalMeshComponent& Component);
+	void UpdateBodyWorldBounds(int32 BodyEntry);
+	void UpdateAllBodyWorldBounds(const FTransform& ComponentToWorld);
+
+	TSharedPtr<const FSharedBodyShapes> Shared;
+	/** Component transform, without scale, that BodyWorldBounds were computed with. */
+	FTransform BoundsComponentToWorld;
+	TArray<FBox> BodyWorldBounds;
+	int32 NumBodyBoundsUpdates = 0;
+	/** True once Shared is a private copy, which may be updated in place while nothing else holds it. */
+	bool bOwnsShapes = false;
+	int32 NumRebuilds = 0;
+	int32 NumBodyUpdates = 0;
+};
@@ -0,0 +1,207 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkeletalMeshBodyTree.h"
+
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "SkeletalMeshBodyShapeCache.h"
+
+namespace
+{
+	/** Leaves are refitted with ParallelFor above this count. */
+	const int32 MinLeavesForParallelRefit = 4096;
+
+	/** The cached shapes are built for the quantized component scale, so their bounds are grown to cover the rounding. */
+	const float CachedBoundsMargin = 1.f;
+
+	const FSkeletalMeshBodyShapeCache* GetSupportedBodyShapes(TArrayView<const FSkeletalMeshBodyShapeCache> BodyShapes, int32 ComponentIndex)
+	{
+		return BodyShapes.IsValidIndex(ComponentIndex) && BodyShapes[ComponentIndex].IsSupported() ? &BodyShapes[ComponentIndex] : nullptr;
+	}
+
+	FBox GetLeafWorldBounds(const FSkeletalMeshBodyTree::FLeaf& Leaf, const USkeletalMeshComponent* Component, const FSkeletalMeshBodyShapeCache* BodyShapes)
+	{
+		if (!Component)
+			return FBox(ForceInit);
+
+		if (BodyShapes && BodyShapes->GetBodyWorldBounds().IsValidIndex(Leaf.BodyEntry))
+			return BodyShapes->GetBodyWorldBounds()[Leaf.BodyEntry].ExpandBy(CachedBoundsMargin);
+
+		const TArray<FTransform>& ComponentSpaceTransforms = Component->GetComponentSpaceTransforms();
+		if (!ComponentSpaceTransforms.IsValidIndex(Leaf.BoneIndex))
+			return FBox(ForceInit);
+
+		return Leaf.LocalBounds.TransformBy(ComponentSpaceTransforms[Leaf.BoneIndex] * Component->GetComponentTransform());
+	}
+}
+
+void FSkeletalMeshBodyTree::Build(TArrayView<USkeletalMeshComponent* const> Components, TArrayView<const FSkeletalMeshBodyShapeCache> BodyShapes)
+{
+	Leaves.Reset();
+	LeafBounds.Reset();
+	Nodes.Reset();
+
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	{
+		const USkeletalMeshComponent* Component = Components[ComponentIndex];
+		const UPhysicsAsset* PhysicsAsset = Component ? Component->GetPhysicsAsset() : nullptr;
+		if (!PhysicsAsset)
+			continue;
+
+		// Cache body entries are ordered by physics asset body index, which is what InstanceBodyIndex holds
+		const FSkeletalMeshBodyShapeCache* ComponentBodyShapes = GetSupportedBodyShapes(BodyShapes, ComponentIndex);
+		for (int32 BodyIndex = 0; BodyIndex < Component->Bodies.Num(); BodyIndex++)
+		{
+			const FBodyInstance* Body = Component->Bodies[BodyIndex];
+			const UBodySetup* BodySetup = Body ? Body->BodySetup.Get() : nullptr;
+			const int32 BoneIndex = BodySetup ? Component->GetBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+			if (BoneIndex == INDEX_NONE)
+				continue;
+
+			FLeaf& Leaf = Leaves.AddDefaulted_GetRef();
+			Leaf.ComponentIndex = ComponentIndex;
+			Leaf.BodyIndex = BodyIndex;
+			Leaf.BoneIndex = BoneIndex;
+			Leaf.BodyEntry = ComponentBodyShapes ? Algo::BinarySearch(ComponentBodyShapes->GetShared()->BodyIndices, Body->InstanceBodyIndex) : INDEX_NONE;
+			Leaf.LocalBounds = BodySetup->AggGeom.CalcAABB(FTransform::Identity);
+			LeafBounds.Add(GetLeafWorldBounds(Leaf, Component, ComponentBodyShapes));
+		}
+	}
+
+	if (Leaves.Num() > 0)
+	{
+		Nodes.Reserve(2 * FMath::DivideAndRoundUp(Leaves.Num(), MaxLeavesPerNode));
+		Nodes.AddDefaulted();
+		BuildNode(0, 0, Leaves.Num());
+	}
+}
+
+void FSkeletalMeshBodyTree::BuildNode(int32 NodeIndex, int32 FirstLeaf, int32 NumLeaves)
+{
+	FBox Bounds(ForceInit);
+	FBox CenterBounds(ForceInit);
+	for (int32 LeafIndex = FirstLeaf; LeafIndex < FirstLeaf + NumLeaves; LeafIndex++)
+	{
+		Bounds += LeafBounds[LeafIndex];
+		CenterBounds += LeafBounds[LeafIndex].GetCenter();
+	}
+	Nodes[NodeIndex].Bounds = Bounds;
+
+	if (NumLeaves <= MaxLeavesPerNode)
+	{
+		Nodes[NodeIndex].FirstChild = INDEX_NONE;
+		Nodes[NodeIndex].FirstLeaf = FirstLeaf;
+		Nodes[NodeIndex].NumLeaves = NumLeaves;
+		return;
+	}
+
+	// Median split of the leaf centers along the longest axis
+	const FVector CenterExtent = CenterBounds.GetExtent();
+	const int32 Axis = CenterExtent.X >= CenterExtent.Y && CenterExtent.X >= CenterExtent.Z ? 0 : (CenterExtent.Y >= CenterExtent.Z ? 1 : 2);
+	TArray<int32> Order;
+	Order.Reserve(NumLeaves);
+	for (int32 LeafIndex = FirstLeaf; LeafIndex < FirstLeaf + NumLeaves; LeafIndex++)
+		Order.Add(LeafIndex);
+	const int32 NumLeftLeaves = NumLeaves / 2;
+	std::nth_element(Order.GetData(), Order.GetData() + NumLeftLeaves, Order.GetData() + NumLeaves, [this, Axis](int32 A, int32 B)
+		{
+			return LeafBounds[A].GetCenter()[Axis] < LeafBounds[B].GetCenter()[Axis];
+		});
+
+	TArray<FLeaf> SortedLeaves;
+	TArray<FBox> SortedLeafBounds;
+	SortedLeaves.Reserve(NumLeaves);
+	SortedLeafBounds.Reserve(NumLeaves);
+	for (int32 LeafIndex : Order)
+	{
+		SortedLeaves.Add(Leaves[LeafIndex]);
+		SortedLeafBounds.Add(LeafBounds[LeafIndex]);
+	}
+	FMemory::Memcpy(Leaves.GetData() + FirstLeaf, SortedLeaves.GetData(), NumLeaves * sizeof(FLeaf));
+	FMemory::Memcpy(LeafBounds.GetData() + FirstLeaf, SortedLeafBounds.GetData(), NumLeaves * sizeof(FBox));
+
+	// Both children are allocated before either is built, so they are adjacent and come after their parent
+	const int32 FirstChild = Nodes.AddDefaulted(2);
+	Nodes[NodeIndex].FirstChild = FirstChild;
+	Nodes[NodeIndex].FirstLeaf = INDEX_NONE;
+	Nodes[NodeIndex].NumLeaves = 0;
+	BuildNode(FirstChild, FirstLeaf, NumLeftLeaves);
+	BuildNode(FirstChild + 1, FirstLeaf + NumLeftLeaves, NumLeaves - NumLeftLeaves);
+}
+
+void FSkeletalMeshBodyTree::Refit(TArrayView<USkeletalMeshComponent* const> Components, TArrayView<const FSkeletalMeshBodyShapeCache> BodyShapes)
+{
+	auto RefitLeaf = [this, Components, BodyShapes](int32 LeafIndex)
+	{
+		const FLeaf& Leaf = Leaves[LeafIndex];
+		LeafBounds[LeafIndex] = GetLeafWorldBounds(Leaf, Components.IsValidIndex(Leaf.ComponentIndex) ? Components[Leaf.ComponentIndex] : nullptr, GetSupportedBodyShapes(BodyShapes, Leaf.ComponentIndex));
+	};
+
+	if (Leaves.Num() >= MinLeavesForParallelRefit)
+		ParallelFor(Leaves.Num(), RefitLeaf);
+	else
+		for (int32 LeafIndex = 0; LeafIndex < Leaves.Num(); LeafIndex++)
+			RefitLeaf(LeafIndex);
+
+	for (int32 NodeIndex = Nodes.Num() - 1; NodeIndex >= 0; NodeIndex--)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		if (Node.NumLeaves == 0)
+		{
+			Node.Bounds = Nodes[Node.FirstChild].Bounds + Nodes[Node.FirstChild + 1].Bounds;
+			continue;
+		}
+
+		Node.Bounds = FBox(ForceInit);
+		for (int32 LeafIndex = Node.FirstLeaf; LeafIndex < Node.FirstLeaf + Node.NumLeaves; LeafIndex++)
+			Node.Bounds += LeafBounds[LeafIndex];
+	}
+}
+
+FVector FSkeletalMeshBodyTree::GetShapeBoundsExtent(const FCollisionShape& Shape, const FQuat& Rot)
+{
+	switch (Shape.ShapeType)
+	{
+	case ECollisionShape::Box:
+	{
+		const FVector HalfExtent = Shape.GetBox();
+		const FVector AxisX = Rot.GetAxisX().GetAbs() * HalfExtent.X;
+		const FVector AxisY = Rot.GetAxisY().GetAbs() * HalfExtent.Y;
+		const FVector AxisZ = Rot.GetAxisZ().GetAbs() * HalfExtent.Z;
+		return AxisX + AxisY + AxisZ;
+	}
+	case ECollisionShape::Sphere:
+		return FVector(Shape.GetSphereRadius());
+	case ECollisionShape::Capsule:
+		return Rot.GetAxisZ().GetAbs() * Shape.GetCapsuleAxisHalfLength() + FVector(Shape.GetCapsuleRadius());
+	default:
+		return FVector::ZeroVector;
+	}
+}
+
+bool FSkeletalMeshBodyTree::IntersectSegment(const FBox& Bounds, const FVector& Start, const FVector& InvDelta, float MaxTime, float& OutEntryTime)
+{
+	if (!Bounds.IsValid)
+		return false;
+
+	float EntryTime = 0.f;
+	float ExitTime = MaxTime;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		float Time0 = (Bounds.Min[Axis] - Start[Axis]) * InvDelta[Axis];
+		float Time1 = (Bounds.Max[Axis] - Start[Axis]) * InvDelta[Axis];
+		if (Time0 > Time1)
+			Swap(Time0, Time1);
+		EntryTime = FMath::Max(EntryTime, Time0);
+		ExitTime = FMath::Min(ExitTime, Time1);
+		if (EntryTime > ExitTime)
+			return false;
+	}
+
+	OutEntryTime = EntryTime;
+	return true;
+}
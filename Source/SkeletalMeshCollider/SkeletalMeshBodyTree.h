@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionShape.h"
+
+class FSkeletalMeshBodyShapeCache;
+class USkeletalMeshComponent;
+
+/**
+ * Bounding volume hierarchy over the physics asset bodies of a set of skeletal mesh components.
+ *
+ * The leaves hold the bone space bounds of every body, taken once from the physics asset; the topology is built
+ * once from the poses at build time, with a median split along the longest axis. Afterwards Refit() only moves
+ * the bounds, bottom-up, from the current bone and component transforms, which is much cheaper than removing and
+ * reinserting every body into a general purpose scene structure. The tree degrades as bodies drift away from where
+ * they were at build time, so callers rebuild it when the set of components changes.
+ *
+ * When the components come with their FSkeletalMeshBodyShapeCache, leaves take the world bounds the cache keeps
+ * for their body instead, which are only recomputed for bodies whose bone or component moved since the last update.
+ */
+class SKELETALMESHCOLLIDER_API FSkeletalMeshBodyTree
+{
+public:
+	struct FLeaf
+	{
+		int32 ComponentIndex;
+		/** Index into USkeletalMeshComponent::Bodies. */
+		int32 BodyIndex;
+		int32 BoneIndex;
+		/** Body entry in the shape cache of the component, or INDEX_NONE when the bounds come from LocalBounds. */
+		int32 BodyEntry;
+		FBox LocalBounds;
+	};
+
+	/** BodyShapes is either empty or holds an up to date shape cache for every component, in the same order. */
+	void Build(TArrayView<USkeletalMeshComponent* const> Components, TArrayView<const FSkeletalMeshBodyShapeCache> BodyShapes = {});
+
+	/**
+	 * Components and BodyShapes must be the same, in the same order, as at build time; destroyed components are
+	 * passed as null.
+	 */
+	void Refit(TArrayView<USkeletalMeshComponent* const> Components, TArrayView<const FSkeletalMeshBodyShapeCache> BodyShapes = {});
+
+	/**
+	 * Visits the leaves whose bounds, grown by QueryExtent, are crossed by the segment from Start to End, in no
+	 * particular order. Visitor takes (const FLeaf&, float EntryTime) and returns the time after which leaves are
+	 * no longer of interest, which lets single hit queries prune the rest of the tree; multi hit queries return 1.
+	 */
+	template <typename VisitorType>
+	void Sweep(const FVector& Start, const FVector& End, const FVector& QueryExtent, VisitorType&& Visitor) const;
+
+	int32 GetNumLeaves() const { return Leaves.Num(); }
+	int32 GetNumNodes() const { return Nodes.Num(); }
+
+	/** Half extents of the world space box that contains Shape with rotation Rot. */
+	static FVector GetShapeBoundsExtent(const FCollisionShape& Shape, const FQuat& Rot);
+
+private:
+	/** Leaves [FirstLeaf, FirstLeaf + NumLeaves) when NumLeaves > 0; otherwise children at FirstChild and FirstChild + 1. */
+	struct FNode
+	{
+		FBox Bounds;
+		int32 FirstChild;
+		int32 FirstLeaf;
+		int32 NumLeaves;
+	};
+
+	static constexpr int32 MaxLeavesPerNode = 4;
+
+	void BuildNode(int32 NodeIndex, int32 FirstLeaf, int32 NumLeaves);
+	static bool IntersectSegment(const FBox& Bounds, const FVector& Start, const FVector& InvDelta, float MaxTime, float& OutEntryTime);
+
+	TArray<FLeaf> Leaves;
+	TArray<FBox> LeafBounds;
+	/** Nodes are stored parents first, so refitting them in reverse order visits children before their parent. */
+	TArray<FNode> Nodes;
+};
+
+template <typename VisitorType>
+void FSkeletalMeshBodyTree::Sweep(const FVector& Start, const FVector& End, const FVector& QueryExtent, VisitorType&& Visitor) const
+{
+	if (Nodes.Num() == 0)
+		return;
+
+	const FVector Delta = End - Start;
+	const FVector InvDelta(
+		FMath::IsNearlyZero(Delta.X) ? BIG_NUMBER : 1.f / Delta.X,
+		FMath::IsNearlyZero(Delta.Y) ? BIG_NUMBER : 1.f / Delta.Y,
+		FMath::IsNearlyZero(Delta.Z) ? BIG_NUMBER : 1.f / Delta.Z);
+
+	float MaxTime = 1.f;
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Add(0);
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = Nodes[Stack.Pop(false)];
+		float EntryTime;
+		if (!IntersectSegment(Node.Bounds.ExpandBy(QueryExtent), Start, InvDelta, MaxTime, EntryTime))
+			continue;
+
+		if (Node.NumLeaves == 0)
+		{
+			Stack.Add(Node.FirstChild);
+			Stack.Add(Node.FirstChild + 1);
+			continue;
+		}
+
+		for (int32 LeafIndex = Node.FirstLeaf; LeafIndex < Node.FirstLeaf + Node.NumLeaves; LeafIndex++)
+			if (IntersectSegment(LeafBounds[LeafIndex].ExpandBy(QueryExtent), Start, InvDelta, MaxTime, EntryTime))
+				MaxTime = FMath::Min(MaxTime, Visitor(Leaves[LeafIndex], EntryTime));
+	}
+}
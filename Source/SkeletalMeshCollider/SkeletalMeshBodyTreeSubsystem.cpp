@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkeletalMeshBodyTreeSubsystem.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+void USkeletalMeshBodyTreeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &USkeletalMeshBodyTreeSubsystem::OnWorldPostActorTick);
+}
+
+void USkeletalMeshBodyTreeSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	for (int32 Index = Components.Num() - 1; Index >= 0; Index--)
+		UnregisterComponent(Components[Index]);
+	Components.Reset();
+	RegisteredComponents.Reset();
+	BodyShapes.Reset();
+	Super::Deinitialize();
+}
+
+bool USkeletalMeshBodyTreeSubsystem::RegisterComponent(USkeletalMeshComponent* Component)
+{
+	if (!Component)
+		return false;
+	if (Components.Contains(Component))
+		return true;
+
+	const ECollisionEnabled::Type CollisionEnabled = Component->GetCollisionEnabled();
+	if (!CollisionEnabledHasQuery(CollisionEnabled))
+		return false;
+
+	FRegisteredComponent& Registered = RegisteredComponents.AddDefaulted_GetRef();
+	Registered.CollisionEnabled = CollisionEnabled;
+	Registered.Responses = Component->GetCollisionResponseToChannels();
+	BodyShapes.AddDefaulted();
+	Components.Add(Component);
+	Component->SetCollisionEnabled(CollisionEnabledHasPhysics(CollisionEnabled) ? ECollisionEnabled::PhysicsOnly : ECollisionEnabled::NoCollision);
+	bTreeDirty = true;
+	return true;
+}
+
+void USkeletalMeshBodyTreeSubsystem::UnregisterComponent(USkeletalMeshComponent* Component)
+{
+	const int32 Index = Components.Find(Component);
+	if (Index == INDEX_NONE)
+		return;
+
+	if (Component && !Component->IsPendingKill())
+		Component->SetCollisionEnabled(RegisteredComponents[Index].CollisionEnabled);
+	Components.RemoveAtSwap(Index);
+	RegisteredComponents.RemoveAtSwap(Index);
+	BodyShapes.RemoveAtSwap(Index);
+	bTreeDirty = true;
+}
+
+void USkeletalMeshBodyTreeSubsystem::Refit()
+{
+	// Destroyed components are dropped here rather than on destruction, which the subsystem is not told about
+	for (int32 Index = Components.Num() - 1; Index >= 0; Index--)
+	{
+		if (!IsValid(Components[Index]))
+		{
+			Components.RemoveAtSwap(Index);
+			RegisteredComponents.RemoveAtSwap(Index);
+			BodyShapes.RemoveAtSwap(Index);
+			bTreeDirty = true;
+		}
+	}
+
+	if (bTreeDirty)
+	{
+		RebuildIfNeeded();
+		return;
+	}
+
+	UpdateBodyShapes();
+	Tree.Refit(Components, BodyShapes);
+}
+
+const FSkeletalMeshBodyShapeCache* USkeletalMeshBodyTreeSubsystem::FindBodyShapes(const USkeletalMeshComponent* Component) const
+{
+	const int32 Index = Components.IndexOfByKey(Component);
+	return Index != INDEX_NONE ? &BodyShapes[Index] : nullptr;
+}
+
+void USkeletalMeshBodyTreeSubsystem::OnWorldPostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (TickedWorld == GetWorld() && Components.Num() > 0)
+		Refit();
+}
+
+void USkeletalMeshBodyTreeSubsystem::RebuildIfNeeded()
+{
+	if (!bTreeDirty)
+		return;
+
+	UpdateBodyShapes();
+	Tree.Build(Components, BodyShapes);
+	bTreeDirty = false;
+}
+
+void USkeletalMeshBodyTreeSubsystem::UpdateBodyShapes()
+{
+	// Only the bodies whose bone moved, or all of them when the component moved, get new world bounds
+	for (int32 Index = 0; Index < Components.Num(); Index++)
+		if (IsValid(Components[Index]))
+			BodyShapes[Index].Update(*Components[Index]);
+}
+
+bool USkeletalMeshBodyTreeSubsystem::SweepSingleByChannel(FHitResult& OutHit, const FVector& Start, const FVector& End, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& Shape, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams)
+{
+	OutHit = FHitResult(1.f);
+	UWorld* World = GetWorld();
+	if (!World)
+		return false;
+
+	World->SweepSingleByChannel(OutHit, Start, End, Rot, TraceChannel, Shape, Params, ResponseParams);
+
+	WorldHits.Reset();
+	SweepTree(WorldHits, Start, End, Rot, TraceChannel, Shape, Params, ResponseParams, true);
+	for (const FHitResult& Hit : WorldHits)
+		if (!OutHit.bBlockingHit || Hit.Time < OutHit.Time)
+			OutHit = Hit;
+
+	return OutHit.bBlockingHit;
+}
+
+bool USkeletalMeshBodyTreeSubsystem::SweepMultiByChannel(TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& Shape, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams)
+{
+	OutHits.Reset();
+	UWorld* World = GetWorld();
+	if (!World)
+		return false;
+
+	World->SweepMultiByChannel(OutHits, Start, End, Rot, TraceChannel, Shape, Params, ResponseParams);
+	SweepTree(OutHits, Start, End, Rot, TraceChannel, Shape, Params, ResponseParams, false);
+	return USkeletalMeshSweepSubsystem::FinalizeSweepHits(OutHits);
+}
+
+bool USkeletalMeshBodyTreeSubsystem::ComponentSweepMulti(TArray<FHitResult>& OutHits, UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params)
+{
+	OutHits.Reset();
+	UWorld* World = GetWorld();
+	if (!World || !Component)
+		return false;
+
+	// Registered components have no query collision, but they can still be swept with the collision they had before
+	const int32 RegisteredIndex = Components.IndexOfByKey(Component);
+	const bool bQueryCollisionEnabled = RegisteredIndex != INDEX_NONE
+		? CollisionEnabledHasQuery(RegisteredComponents[RegisteredIndex].CollisionEnabled)
+		: Component->IsQueryCollisionEnabled();
+	if (!bQueryCollisionEnabled)
+		return false;
+
+	// As UWorld::ComponentSweepMulti does, the swept component never hits itself; the tree would otherwise see it
+	// when it is registered
+	FComponentQueryParams SweepParams(Params);
+	SweepParams.AddIgnoredComponent(Component);
+	const ECollisionChannel TraceChannel = Component->GetCollisionObjectType();
+	const FCollisionResponseParams ResponseParams(RegisteredIndex != INDEX_NONE ? RegisteredComponents[RegisteredIndex].Responses : Component->GetCollisionResponseToChannels());
+	const FVector Delta = End - Start;
+
+	auto SweepShapes = [&](TArrayView<const FCachedBodyShape> Shapes)
+	{
+		for (const FCachedBodyShape& BodyShape : Shapes)
+		{
+			const FVector ShapeStart = Start + Rot.RotateVector(BodyShape.ShapeToComponent.GetLocation());
+			SweepMultiByChannel(WorldHits, ShapeStart, ShapeStart + Delta, Rot * BodyShape.ShapeToComponent.GetRotation(), TraceChannel, BodyShape.Shape, SweepParams, ResponseParams);
+			for (FHitResult& Hit : WorldHits)
+			{
+				Hit.Location = Start + Delta * Hit.Time;
+				Hit.TraceStart = Start;
+				Hit.TraceEnd = End;
+				Hit.MyBoneName = BodyShape.BoneName;
+			}
+			OutHits.Append(WorldHits);
+		}
+		return USkeletalMeshSweepSubsystem::FinalizeSweepHits(OutHits);
+	};
+
+	if (USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(Component))
+	{
+		USkeletalMeshSweepSubsystem* SweepSubsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+		const FSkeletalMeshBodyShapeCache* SweptBodyShapes = SweepSubsystem ? &SweepSubsystem->GetBodyShapes(*SkeletalMeshComponent) : nullptr;
+		if (SweptBodyShapes && SweptBodyShapes->IsSupported())
+			return SweepShapes(SweptBodyShapes->GetShapes());
+	}
+	else if (USkeletalMeshSweepSubsystem::GetWeldedShapes(*Component, WeldedShapes))
+		return SweepShapes(WeldedShapes);
+
+	return World->ComponentSweepMulti(OutHits, Component, Start, End, Rot, Params);
+}
+
+void USkeletalMeshBodyTreeSubsystem::SweepTree(TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& Shape, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, bool bBlockingHitOnly)
+{
+	RebuildIfNeeded();
+
+	const auto& IgnoredComponents = Params.GetIgnoredComponents();
+	const auto& IgnoredActors = Params.GetIgnoredActors();
+	Tree.Sweep(Start, End, FSkeletalMeshBodyTree::GetShapeBoundsExtent(Shape, Rot), [&](const FSkeletalMeshBodyTree::FLeaf& Leaf, float EntryTime)
+		{
+			const USkeletalMeshComponent* Component = Components[Leaf.ComponentIndex];
+			if (!IsValid(Component) || IgnoredComponents.Contains(Component->GetUniqueID()) || (Component->GetOwner() && IgnoredActors.Contains(Component->GetOwner()->GetUniqueID())))
+				return 1.f;
+
+			const FRegisteredComponent& Registered = RegisteredComponents[Leaf.ComponentIndex];
+			if (!CollisionEnabledHasQuery(Registered.CollisionEnabled))
+				return 1.f;
+
+			// The engine uses the weaker of the two responses, the one of the body and the one of the query
+			const ECollisionResponse Response = FMath::Min(
+				Registered.Responses.GetResponse(TraceChannel),
+				ResponseParams.CollisionResponse.GetResponse(Component->GetCollisionObjectType()));
+			if (Response == ECR_Ignore || (bBlockingHitOnly && Response != ECR_Block))
+				return 1.f;
+
+			const FBodyInstance* Body = Component->Bodies.IsValidIndex(Leaf.BodyIndex) ? Component->Bodies[Leaf.BodyIndex] : nullptr;
+			FHitResult Hit;
+			if (!Body || !Body->Sweep(Hit, Start, End, Rot, Shape, Params.bTraceComplex))
+				return 1.f;
+
+			Hit.bBlockingHit = Response == ECR_Block;
+			OutHits.Add(Hit);
+			return bBlockingHitOnly ? Hit.Time : 1.f;
+		});
+}
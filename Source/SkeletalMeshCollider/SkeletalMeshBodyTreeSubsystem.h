@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Engine/EngineTypes.h"
+#include "SkeletalMeshBodyShapeCache.h"
+#include "SkeletalMeshBodyTree.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SkeletalMeshBodyTreeSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ * Moves the bodies of registered skeletal mesh components out of the physics scene query structure and into an
+ * FSkeletalMeshBodyTree, which is refitted after every actor tick instead of updating the scene for every moving
+ * body.
+ *
+ * Registration is opt-in and changes what the rest of the game sees. UWorld queries cannot be routed through the
+ * tree without changing the engine, so registered components have their query collision switched off,
+ * QueryAndPhysics becoming PhysicsOnly and QueryOnly becoming NoCollision. From then on every engine query,
+ * including character movement, overlaps, AI and gameplay traces, no longer sees them; only the
+ * SweepSingleByChannel, SweepMultiByChannel and ComponentSweepMulti of this subsystem, which combine the world
+ * with the tree, do. Register only components that all queries against them go through this subsystem for.
+ *
+ * Registered components keep simulating. Hits against the tree use FBodyInstance::Sweep as narrowphase and the
+ * collision settings the components had when they were registered. Each registered component keeps an
+ * FSkeletalMeshBodyShapeCache, so refitting an animating component only recomputes the bounds of the bodies whose
+ * bone moved.
+ */
+UCLASS()
+class SKELETALMESHCOLLIDER_API USkeletalMeshBodyTreeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Moves Component into the tree. Engine queries stop seeing Component until it is unregistered; see above.
+	 * The tree is rebuilt lazily, on the next refit or query, after components have been added or removed.
+	 * Components without query collision are not registered, since no query could hit them; returns whether
+	 * Component is registered.
+	 */
+	bool RegisterComponent(USkeletalMeshComponent* Component);
+	void UnregisterComponent(USkeletalMeshComponent* Component);
+
+	/** Rebuilds the tree if needed, otherwise refits it; called after every actor tick of the world. */
+	void Refit();
+
+	bool SweepSingleByChannel(FHitResult& OutHit, const FVector& Start, const FVector& End, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& Shape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParams = FCollisionResponseParams::DefaultResponseParam);
+	bool SweepMultiByChannel(TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& Shape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParams = FCollisionResponseParams::DefaultResponseParam);
+
+	/**
+	 * Same contract as UWorld::ComponentSweepMulti, for box, sphere and capsule components with the shape
+	 * components welded to them, and for skeletal mesh components whose body shapes USkeletalMeshSweepSubsystem
+	 * supports; other components are swept against the world only.
+	 */
+	bool ComponentSweepMulti(TArray<FHitResult>& OutHits, UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params);
+
+	const FSkeletalMeshBodyTree& GetTree() const { return Tree; }
+	int32 GetNumComponents() const { return Components.Num(); }
+
+	/** The shape cache the tree takes the bounds of a registered component from; null if it is not registered. */
+	const FSkeletalMeshBodyShapeCache* FindBodyShapes(const USkeletalMeshComponent* Component) const;
+
+private:
+	struct FRegisteredComponent
+	{
+		ECollisionEnabled::Type CollisionEnabled;
+		FCollisionResponseContainer Responses;
+	};
+
+	void OnWorldPostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds);
+	void RebuildIfNeeded();
+	void UpdateBodyShapes();
+	/**
+	 * Appends the hits against the tree, unsorted and including those after a blocking hit. With bBlockingHitOnly,
+	 * only blocking hits are reported, and the traversal skips the bodies that can only be hit after one of them.
+	 */
+	void SweepTree(TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& Shape, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, bool bBlockingHitOnly);
+
+	UPROPERTY()
+	TArray<USkeletalMeshComponent*> Components;
+	TArray<FRegisteredComponent> RegisteredComponents;
+	/** Shape cache of every registered component, in the order of Components. */
+	TArray<FSkeletalMeshBodyShapeCache> BodyShapes;
+	FSkeletalMeshBodyTree Tree;
+	bool bTreeDirty = false;
+	FDelegateHandle PostActorTickHandle;
+	TArray<FHitResult> WorldHits;
+	TArray<FCachedBodyShape> WeldedShapes;
+};
@@ -3,13 +3,27 @@
 #include "SkeletalMeshCollider.h"
 #include "Modules/ModuleManager.h"
 #include "AutomationTest.h"
+#include "SkeletalMeshRefPoseData.h"
+#include "Specs/ComponentCollisionSpecRegistry.h"
+
+DEFINE_LOG_CATEGORY(LogSkeletalMeshCollider);
 
 class FTestModuleImpl : public FDefaultGameModuleImpl {
 
+	void StartupModule() override {
+		FDefaultGameModuleImpl::StartupModule();
+		FComponentCollisionSpecRegistry::RunShardFromCommandLine();
+#if WITH_EDITOR
+		USkeletalMeshRefPoseData::RegisterBakeHooks();
+#endif
+	}
+
 	void ShutdownModule() override {
-		/* Workaround for UE-25350 */
-		FAutomationTestFramework::Get().UnregisterAutomationTest("FComponentSweepSpec");
-		// ... for every test you defined.
+#if WITH_EDITOR
+		USkeletalMeshRefPoseData::UnregisterBakeHooks();
+#endif
+		/* Workaround for UE-25350; specs defined with END_DEFINE_COMPONENT_COLLISION_SPEC register themselves */
+		FComponentCollisionSpecRegistry::UnregisterAll();
 	}
 };
 
@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkeletalMeshRefPoseData.h"
+
+#include "Engine/SkeletalMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "SkeletalMeshCollider.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+#if WITH_EDITOR
+#include "AssetRegistryModule.h"
+#include "Editor.h"
+#include "FileHelpers.h"
+#include "HAL/IConsoleManager.h"
+#endif
+
+namespace
+{
+	uint32 HashTransform(const FTransform& Transform, uint32 Hash)
+	{
+		const FVector Translation = Transform.GetTranslation();
+		const FQuat Rotation = Transform.GetRotation();
+		const FVector Scale3D = Transform.GetScale3D();
+		const float Values[] = {
+			Translation.X, Translation.Y, Translation.Z,
+			Rotation.X, Rotation.Y, Rotation.Z, Rotation.W,
+			Scale3D.X, Scale3D.Y, Scale3D.Z
+		};
+		return FCrc::MemCrc32(Values, sizeof(Values), Hash);
+	}
+
+#if WITH_EDITOR
+	FDelegateHandle PostImportHandle;
+	FDelegateHandle PreSavePackageHandle;
+
+	FAutoConsoleCommand BakeCommand(
+		TEXT("SkeletalMeshRefPoseData.Bake"),
+		TEXT("Bakes ref pose data into every skeletal mesh under the given content path, /Game by default, and saves them"),
+		FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+			{
+				const FString ContentPath = Args.Num() > 0 ? Args[0] : TEXT("/Game");
+				const int32 NumSaved = USkeletalMeshRefPoseData::BakeAndSaveAssets(ContentPath);
+				UE_LOG(LogSkeletalMeshCollider, Display, TEXT("Baked ref pose data into %d skeletal meshes under %s"), NumSaved, *ContentPath);
+			}));
+
+	void OnAssetPostImport(UFactory* Factory, UObject* CreatedObject)
+	{
+		if (USkeletalMesh* SkeletalMesh = Cast<USkeletalMesh>(CreatedObject))
+		{
+			USkeletalMeshRefPoseData::Bake(*SkeletalMesh);
+			SkeletalMesh->MarkPackageDirty();
+		}
+	}
+
+	/** Only rewrites data the mesh already has; new objects can't be created while saving. */
+	void OnPreSavePackage(UPackage* Package)
+	{
+		ForEachObjectWithOuter(Package, [](UObject* Object)
+			{
+				USkeletalMesh* SkeletalMesh = Cast<USkeletalMesh>(Object);
+				if (USkeletalMeshRefPoseData* RefPoseData = SkeletalMesh ? SkeletalMesh->GetAssetUserData<USkeletalMeshRefPoseData>() : nullptr)
+					RefPoseData->BakeFrom(*SkeletalMesh);
+			}, false);
+	}
+#endif
+}
+
+const USkeletalMeshRefPoseData* USkeletalMeshRefPoseData::Find(const USkeletalMesh& SkeletalMesh)
+{
+	const TArray<UAssetUserData*>* AssetUserData = SkeletalMesh.GetAssetUserDataArray();
+	if (!AssetUserData)
+		return nullptr;
+
+	for (const UAssetUserData* UserData : *AssetUserData)
+	{
+		const USkeletalMeshRefPoseData* RefPoseData = Cast<USkeletalMeshRefPoseData>(UserData);
+		if (RefPoseData
+			&& RefPoseData->ComponentSpaceRefPose.Num() == SkeletalMesh.GetRefSkeleton().GetNum()
+			&& RefPoseData->RefSkeletonHash == CalcRefSkeletonHash(SkeletalMesh.GetRefSkeleton()))
+			return RefPoseData;
+	}
+	return nullptr;
+}
+
+USkeletalMeshRefPoseData* USkeletalMeshRefPoseData::Bake(USkeletalMesh& SkeletalMesh)
+{
+	USkeletalMeshRefPoseData* RefPoseData = SkeletalMesh.GetAssetUserData<USkeletalMeshRefPoseData>();
+	if (!RefPoseData)
+	{
+		RefPoseData = NewObject<USkeletalMeshRefPoseData>(&SkeletalMesh, NAME_None, RF_Transactional);
+		SkeletalMesh.AddAssetUserData(RefPoseData);
+	}
+
+	RefPoseData->BakeFrom(SkeletalMesh);
+	return RefPoseData;
+}
+
+void USkeletalMeshRefPoseData::BakeFrom(const USkeletalMesh& SkeletalMesh)
+{
+	ComposeComponentSpaceRefPose(SkeletalMesh.GetRefSkeleton(), ComponentSpaceRefPose);
+	RefSkeletonHash = CalcRefSkeletonHash(SkeletalMesh.GetRefSkeleton());
+	PhysicsAsset = SkeletalMesh.PhysicsAsset;
+	CollisionBounds = SkeletalMesh.PhysicsAsset ? CalcCollisionBounds(SkeletalMesh, *SkeletalMesh.PhysicsAsset, ComponentSpaceRefPose) : FBox(ForceInit);
+}
+
+uint32 USkeletalMeshRefPoseData::CalcRefSkeletonHash(const FReferenceSkeleton& RefSkeleton)
+{
+	// Names are hashed as strings, since name indices differ from one run to the next
+	const TArray<FMeshBoneInfo>& RefBoneInfo = RefSkeleton.GetRefBoneInfo();
+	const TArray<FTransform>& RefBonePose = RefSkeleton.GetRefBonePose();
+	uint32 Hash = 0;
+	for (int32 BoneIndex = 0; BoneIndex < RefBoneInfo.Num(); BoneIndex++)
+	{
+		Hash = FCrc::StrCrc32(*RefBoneInfo[BoneIndex].Name.ToString(), Hash);
+		Hash = FCrc::MemCrc32(&RefBoneInfo[BoneIndex].ParentIndex, sizeof(int32), Hash);
+		if (RefBonePose.IsValidIndex(BoneIndex))
+			Hash = HashTransform(RefBonePose[BoneIndex], Hash);
+	}
+	return Hash;
+}
+
+void USkeletalMeshRefPoseData::ComposeComponentSpaceRefPose(const FReferenceSkeleton& RefSkeleton, TArray<FTransform>& OutTransforms)
+{
+	const TArray<FTransform>& RefBonePose = RefSkeleton.GetRefBonePose();
+	OutTransforms.SetNum(RefSkeleton.GetNum());
+
+	// Parents always come before their children in the reference skeleton
+	for (int32 BoneIndex = 0; BoneIndex < OutTransforms.Num(); BoneIndex++)
+	{
+		const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+		OutTransforms[BoneIndex] = ParentIndex == INDEX_NONE ? RefBonePose[BoneIndex] : RefBonePose[BoneIndex] * OutTransforms[ParentIndex];
+	}
+}
+
+FBox USkeletalMeshRefPoseData::CalcCollisionBounds(const USkeletalMesh& SkeletalMesh, const UPhysicsAsset& PhysicsAsset, const TArray<FTransform>& ComponentSpaceRefPose)
+{
+	FBox Bounds(ForceInit);
+	for (const USkeletalBodySetup* BodySetup : PhysicsAsset.SkeletalBodySetups)
+	{
+		const int32 BoneIndex = BodySetup ? SkeletalMesh.GetRefSkeleton().FindBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+		if (ComponentSpaceRefPose.IsValidIndex(BoneIndex))
+			Bounds += BodySetup->AggGeom.CalcAABB(ComponentSpaceRefPose[BoneIndex]);
+	}
+	return Bounds;
+}
+
+FBox USkeletalMeshRefPoseData::GetCollisionBounds(const USkeletalMesh& SkeletalMesh, const UPhysicsAsset& PhysicsAsset)
+{
+	const USkeletalMeshRefPoseData* RefPoseData = Find(SkeletalMesh);
+	if (RefPoseData && RefPoseData->PhysicsAsset == &PhysicsAsset)
+		return RefPoseData->CollisionBounds;
+	if (RefPoseData)
+		return CalcCollisionBounds(SkeletalMesh, PhysicsAsset, RefPoseData->ComponentSpaceRefPose);
+
+	TArray<FTransform> ComponentSpaceRefPose;
+	ComposeComponentSpaceRefPose(SkeletalMesh.GetRefSkeleton(), ComponentSpaceRefPose);
+	return CalcCollisionBounds(SkeletalMesh, PhysicsAsset, ComponentSpaceRefPose);
+}
+
+#if WITH_EDITOR
+void USkeletalMeshRefPoseData::RegisterBakeHooks()
+{
+	PostImportHandle = FEditorDelegates::OnAssetPostImport.AddStatic(&OnAssetPostImport);
+	PreSavePackageHandle = UPackage::PreSavePackageEvent.AddStatic(&OnPreSavePackage);
+}
+
+void USkeletalMeshRefPoseData::UnregisterBakeHooks()
+{
+	FEditorDelegates::OnAssetPostImport.Remove(PostImportHandle);
+	UPackage::PreSavePackageEvent.Remove(PreSavePackageHandle);
+}
+
+int32 USkeletalMeshRefPoseData::BakeAndSaveAssets(const FString& ContentPath)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.ScanPathsSynchronous({ ContentPath });
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssetsByPath(*ContentPath, Assets, true);
+
+	TArray<UPackage*> Packages;
+	for (const FAssetData& Asset : Assets)
+	{
+		if (Asset.AssetClass != USkeletalMesh::StaticClass()->GetFName())
+			continue;
+
+		if (USkeletalMesh* SkeletalMesh = Cast<USkeletalMesh>(Asset.GetAsset()))
+		{
+			Bake(*SkeletalMesh);
+			SkeletalMesh->MarkPackageDirty();
+			Packages.Add(SkeletalMesh->GetOutermost());
+		}
+	}
+
+	return Packages.Num() > 0 && UEditorLoadingAndSavingUtils::SavePackages(Packages, false) ? Packages.Num() : 0;
+}
+#endif
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "SkeletalMeshRefPoseData.generated.h"
+
+class UPhysicsAsset;
+class USkeletalMesh;
+struct FReferenceSkeleton;
+
+/**
+ * Ref pose data baked into a skeletal mesh asset: the component space transform of every bone, and the bounds of
+ * the physics asset bodies in that pose. FPhysicsAssetCollapse and the collision LOD proxy of
+ * USkeletalMeshSweepSubsystem read it instead of composing the ref pose by walking the bone hierarchy.
+ *
+ * Component registration can't use it: the engine fills the component space transforms of a component from its
+ * own bone evaluation when it registers, and FSkeletalMeshBodyShapeCache builds the shapes of the first query
+ * from those, not from the ref pose.
+ *
+ * In the editor it is created when a skeletal mesh is imported or reimported, or for existing assets by the
+ * SkeletalMeshRefPoseData.Bake console command, and rebaked every time the package of a mesh that has it is saved,
+ * which includes cooking. Data baked from another ref pose or other bone names than those of the mesh is ignored,
+ * and so are the bounds when the physics asset is not the one they were baked with.
+ */
+UCLASS()
+class SKELETALMESHCOLLIDER_API USkeletalMeshRefPoseData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	/** The data baked into SkeletalMesh, or null if there is none or it is out of date. */
+	static const USkeletalMeshRefPoseData* Find(const USkeletalMesh& SkeletalMesh);
+
+	/** Bakes the data of SkeletalMesh into it, reusing the data it already has. */
+	static USkeletalMeshRefPoseData* Bake(USkeletalMesh& SkeletalMesh);
+
+	/** Rewrites this data from SkeletalMesh without creating any object, so it is safe while saving. */
+	void BakeFrom(const USkeletalMesh& SkeletalMesh);
+
+	/** Hash of the bone names, parents and bone space ref pose of RefSkeleton. */
+	static uint32 CalcRefSkeletonHash(const FReferenceSkeleton& RefSkeleton);
+
+	/** Composes the component space ref pose of RefSkeleton from the bone space one. */
+	static void ComposeComponentSpaceRefPose(const FReferenceSkeleton& RefSkeleton, TArray<FTransform>& OutTransforms);
+
+	/** Bounds of the bodies of PhysicsAsset whose bones exist in SkeletalMesh, with the bones at ComponentSpaceRefPose. */
+	static FBox CalcCollisionBounds(const USkeletalMesh& SkeletalMesh, const UPhysicsAsset& PhysicsAsset, const TArray<FTransform>& ComponentSpaceRefPose);
+
+	/** The collision bounds of SkeletalMesh with PhysicsAsset, baked if possible; invalid if it has no bodies. */
+	static FBox GetCollisionBounds(const USkeletalMesh& SkeletalMesh, const UPhysicsAsset& PhysicsAsset);
+
+#if WITH_EDITOR
+	/** Bakes skeletal meshes when they are imported, and rebakes those that have data when their packages are saved. */
+	static void RegisterBakeHooks();
+	static void UnregisterBakeHooks();
+
+	/** Bakes every skeletal mesh under ContentPath and saves them; returns the number of meshes saved. */
+	static int32 BakeAndSaveAssets(const FString& ContentPath);
+#endif
+
+	UPROPERTY()
+	TArray<FTransform> ComponentSpaceRefPose;
+
+	/** CalcRefSkeletonHash of the skeleton the data was baked from. */
+	UPROPERTY()
+	uint32 RefSkeletonHash = 0;
+
+	/** Unscaled component space bounds of the bodies of PhysicsAsset in the ref pose. */
+	UPROPERTY()
+	FBox CollisionBounds = FBox(ForceInit);
+
+	UPROPERTY()
+	UPhysicsAsset* PhysicsAsset = nullptr;
+};
@@ -0,0 +1,289 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SkeletalMeshSweepSubsystem.h"
+
+#include "Components/ShapeComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "DeferredPhysicsStateSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "SkeletalMeshRefPoseData.h"
+
+namespace
+{
+	FAutoConsoleCommandWithWorld BeginSweepCaptureCommand(
+		TEXT("SweepCapture.Begin"),
+		TEXT("Starts recording the sweeps of the current world"),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+			{
+				if (USkeletalMeshSweepSubsystem* Subsystem = World ? World->GetSubsystem<USkeletalMeshSweepSubsystem>() : nullptr)
+					Subsystem->BeginSweepCapture();
+			}));
+
+	FAutoConsoleCommandWithWorldAndArgs EndSweepCaptureCommand(
+		TEXT("SweepCapture.End"),
+		TEXT("Stops recording the sweeps of the current world and saves them to the given path, or to Saved/SweepCaptures"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+			{
+				USkeletalMeshSweepSubsystem* Subsystem = World ? World->GetSubsystem<USkeletalMeshSweepSubsystem>() : nullptr;
+				if (!Subsystem || !Subsystem->GetSweepCapture())
+				{
+					UE_LOG(LogConsoleResponse, Warning, TEXT("No sweep capture is running"));
+					return;
+				}
+
+				const int32 NumQueries = Subsystem->GetSweepCapture()->GetNumQueries();
+				const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("SweepCaptures") / FDateTime::Now().ToString() + TEXT(".sweepcap");
+				if (Subsystem->EndSweepCapture(Path))
+					UE_LOG(LogConsoleResponse, Display, TEXT("Saved %d sweeps to %s"), NumQueries, *Path);
+				else
+					UE_LOG(LogConsoleResponse, Error, TEXT("Could not save the sweep capture to %s"), *Path);
+			}));
+}
+
+void USkeletalMeshSweepSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	for (float& Distance : ChannelProxyDistances)
+		Distance = MAX_flt;
+}
+
+void USkeletalMeshSweepSubsystem::Deinitialize()
+{
+	BodyShapeCaches.Empty();
+	RefPoseBounds.Empty();
+	SweepCapture.Reset();
+	Super::Deinitialize();
+}
+
+bool USkeletalMeshSweepSubsystem::ComponentSweepMulti(TArray<FHitResult>& OutHits, USkeletalMeshComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, float ProxyDistance)
+{
+	check(IsInGameThread());
+	const bool bBlockingHit = SweepComponent(OutHits, Component, Start, End, Rot, Params, ProxyDistance);
+	if (SweepCapture)
+		SweepCapture->RecordSubsystemSweep(Component, Start, End, Rot, Params, LastSweepStats.bProxy, OutHits);
+	return bBlockingHit;
+}
+
+void USkeletalMeshSweepSubsystem::BeginSweepCapture()
+{
+	SweepCapture = MakeUnique<FSweepCaptureWriter>();
+}
+
+bool USkeletalMeshSweepSubsystem::EndSweepCapture(const FString& Path)
+{
+	const TUniquePtr<FSweepCaptureWriter> Capture = MoveTemp(SweepCapture);
+	return Capture && Capture->SaveToFile(Path);
+}
+
+bool USkeletalMeshSweepSubsystem::SweepComponent(TArray<FHitResult>& OutHits, USkeletalMeshComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, float ProxyDistance)
+{
+	OutHits.Reset();
+	LastSweepStats.Reset();
+
+	UWorld* World = GetWorld();
+	if (!World || !Component)
+		return false;
+
+	if (UDeferredPhysicsStateSubsystem* DeferredPhysicsState = World->GetSubsystem<UDeferredPhysicsStateSubsystem>())
+		DeferredPhysicsState->CreateDeferredPhysicsState(*Component);
+	if (!Component->IsQueryCollisionEnabled())
+		return false;
+
+	FCachedBodyShape ProxyShape;
+	const FSkeletalMeshBodyShapeCache* BodyShapes = nullptr;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ComponentSweep_Pose);
+		FComponentSweepPhaseTimer PhaseTimer(LastSweepStats.PoseSeconds);
+		LastSweepStats.bProxy = ShouldUseProxy(*Component, Start, ProxyDistance) && GetProxyShape(*Component, ProxyShape);
+		if (!LastSweepStats.bProxy)
+			BodyShapes = &GetBodyShapes(*Component);
+	}
+	LastSweepStats.NumBodies = BodyShapes ? BodyShapes->GetNumBodies() : 1;
+
+	if (BodyShapes && !BodyShapes->IsSupported())
+	{
+		bool bBlockingHit = false;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_ComponentSweep_SceneQuery);
+			FComponentSweepPhaseTimer PhaseTimer(LastSweepStats.SceneQuerySeconds);
+			bBlockingHit = World->ComponentSweepMulti(OutHits, Component, Start, End, Rot, Params);
+		}
+		LastSweepStats.NumCandidates = LastSweepStats.NumHits = OutHits.Num();
+		LastSweepStats.Publish();
+		return bBlockingHit;
+	}
+
+	const TArrayView<const FCachedBodyShape> Shapes = BodyShapes ? TArrayView<const FCachedBodyShape>(BodyShapes->GetShapes()) : TArrayView<const FCachedBodyShape>(&ProxyShape, 1);
+	LastSweepStats.NumShapes = Shapes.Num();
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ComponentSweep_ShapeSetup);
+		FComponentSweepPhaseTimer PhaseTimer(LastSweepStats.ShapeSetupSeconds);
+		GetShapeStarts(Shapes, Start, Rot, ShapeStarts);
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ComponentSweep_SceneQuery);
+		FComponentSweepPhaseTimer PhaseTimer(LastSweepStats.SceneQuerySeconds);
+		const FCollisionResponseParams ResponseParams(Component->GetCollisionResponseToChannels());
+		SweepShapes(*World, Shapes, ShapeStarts, Start, End, Component->GetCollisionObjectType(), Params, ResponseParams, ShapeHits, OutHits);
+	}
+	LastSweepStats.NumCandidates = OutHits.Num();
+
+	bool bBlockingHit = false;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ComponentSweep_Finalize);
+		FComponentSweepPhaseTimer PhaseTimer(LastSweepStats.FinalizeSeconds);
+		bBlockingHit = FinalizeSweepHits(OutHits);
+	}
+	LastSweepStats.NumHits = OutHits.Num();
+	LastSweepStats.Publish();
+	return bBlockingHit;
+}
+
+void USkeletalMeshSweepSubsystem::SetProxyDistance(ECollisionChannel Channel, float Distance)
+{
+	ChannelProxyDistances[Channel] = Distance >= 0.f ? Distance : MAX_flt;
+}
+
+void USkeletalMeshSweepSubsystem::SetCollisionLODOrigin(const FVector& Origin)
+{
+	CollisionLODOrigin = Origin;
+	bHasCollisionLODOrigin = true;
+}
+
+bool USkeletalMeshSweepSubsystem::GetProxyShape(const USkeletalMeshComponent& Component, FCachedBodyShape& OutShape)
+{
+	const USkeletalMesh* SkeletalMesh = Component.SkeletalMesh;
+	const UPhysicsAsset* PhysicsAsset = Component.GetPhysicsAsset();
+	if (!SkeletalMesh || !PhysicsAsset)
+		return false;
+
+	const TPair<TWeakObjectPtr<const USkeletalMesh>, TWeakObjectPtr<const UPhysicsAsset>> Key(SkeletalMesh, PhysicsAsset);
+	const FBox* Bounds = RefPoseBounds.Find(Key);
+	if (!Bounds)
+		Bounds = &RefPoseBounds.Add(Key, USkeletalMeshRefPoseData::GetCollisionBounds(*SkeletalMesh, *PhysicsAsset));
+	if (!Bounds->IsValid)
+		return false;
+
+	// An axis aligned box in component space stays one under the component scale
+	const FVector ComponentScale = Component.GetComponentScale();
+	OutShape.Shape = FCollisionShape::MakeBox(Bounds->GetExtent() * ComponentScale.GetAbs());
+	OutShape.ShapeToComponent = FTransform(Bounds->GetCenter() * ComponentScale);
+	OutShape.BodyIndex = INDEX_NONE;
+	OutShape.BoneName = NAME_None;
+	return true;
+}
+
+bool USkeletalMeshSweepSubsystem::GetWeldedShapes(const UPrimitiveComponent& Component, TArray<FCachedBodyShape>& OutShapes)
+{
+	OutShapes.Reset();
+	const UShapeComponent* ShapeComponent = Cast<UShapeComponent>(&Component);
+	const FBodyInstance* BodyInstance = Component.GetBodyInstance(NAME_None, false);
+	if (!ShapeComponent || !BodyInstance)
+		return false;
+
+	OutShapes.AddDefaulted_GetRef().Shape = ShapeComponent->GetCollisionShape();
+
+	const FTransform ComponentToWorld(Component.GetComponentQuat(), Component.GetComponentLocation());
+	TArray<USceneComponent*> Children;
+	Component.GetChildrenComponents(true, Children);
+	for (const USceneComponent* Child : Children)
+	{
+		const UPrimitiveComponent* PrimitiveChild = Cast<UPrimitiveComponent>(Child);
+		const FBodyInstance* ChildBodyInstance = PrimitiveChild ? PrimitiveChild->GetBodyInstance(NAME_None, false) : nullptr;
+		if (!ChildBodyInstance || ChildBodyInstance->WeldParent != BodyInstance)
+			continue;
+
+		const UShapeComponent* ShapeChild = Cast<UShapeComponent>(PrimitiveChild);
+		if (!ShapeChild)
+		{
+			OutShapes.Reset();
+			return false;
+		}
+
+		FCachedBodyShape& ChildShape = OutShapes.AddDefaulted_GetRef();
+		ChildShape.Shape = ShapeChild->GetCollisionShape();
+		ChildShape.ShapeToComponent = FTransform(ShapeChild->GetComponentQuat(), ShapeChild->GetComponentLocation()).GetRelativeTransform(ComponentToWorld);
+	}
+
+	return true;
+}
+
+void USkeletalMeshSweepSubsystem::GetShapeStarts(TArrayView<const FCachedBodyShape> Shapes, const FVector& Start, const FQuat& Rot, TArray<FTransform>& OutShapeStarts)
+{
+	OutShapeStarts.Reset();
+	for (const FCachedBodyShape& BodyShape : Shapes)
+		OutShapeStarts.Emplace(Rot * BodyShape.ShapeToComponent.GetRotation(), Start + Rot.RotateVector(BodyShape.ShapeToComponent.GetLocation()));
+}
+
+void USkeletalMeshSweepSubsystem::SweepShapes(const UWorld& World, TArrayView<const FCachedBodyShape> Shapes, TArrayView<const FTransform> ShapeStarts, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, const FComponentQueryParams& Params, const FCollisionResponseParams& ResponseParams, TArray<FHitResult>& ScratchHits, TArray<FHitResult>& OutHits)
+{
+	const FVector Delta = End - Start;
+	for (int32 ShapeIndex = 0; ShapeIndex < Shapes.Num(); ShapeIndex++)
+	{
+		const FTransform& ShapeStart = ShapeStarts[ShapeIndex];
+		World.SweepMultiByChannel(ScratchHits, ShapeStart.GetLocation(), ShapeStart.GetLocation() + Delta, ShapeStart.GetRotation(), TraceChannel, Shapes[ShapeIndex].Shape, Params, ResponseParams);
+
+		for (FHitResult& Hit : ScratchHits)
+		{
+			// Report the location of the component rather than that of the shape, as ComponentSweepMulti does
+			Hit.Location = Start + Delta * Hit.Time;
+			Hit.TraceStart = Start;
+			Hit.TraceEnd = End;
+			Hit.MyBoneName = Shapes[ShapeIndex].BoneName;
+		}
+		OutHits.Append(ScratchHits);
+	}
+}
+
+bool USkeletalMeshSweepSubsystem::FinalizeSweepHits(TArray<FHitResult>& Hits)
+{
+	Hits.StableSort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+
+	const int32 BlockingHitIndex = Hits.IndexOfByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	if (BlockingHitIndex == INDEX_NONE)
+		return false;
+
+	Hits.SetNum(BlockingHitIndex + 1, false);
+	return true;
+}
+
+const FSkeletalMeshBodyShapeCache& USkeletalMeshSweepSubsystem::GetBodyShapes(const USkeletalMeshComponent& Component)
+{
+	check(IsInGameThread());
+	FSkeletalMeshBodyShapeCache* BodyShapes = BodyShapeCaches.Find(&Component);
+	if (!BodyShapes)
+	{
+		if (BodyShapeCaches.Num() >= NextStaleCachePruneNum)
+		{
+			for (auto It = BodyShapeCaches.CreateIterator(); It; ++It)
+				if (!It.Key().IsValid())
+					It.RemoveCurrent();
+			NextStaleCachePruneNum = FMath::Max(BodyShapeCaches.Num() * 2, 64);
+		}
+		BodyShapes = &BodyShapeCaches.Add(&Component);
+	}
+
+	BodyShapes->Update(Component);
+	return *BodyShapes;
+}
+
+void USkeletalMeshSweepSubsystem::InvalidateBodyShapes(const USkeletalMeshComponent& Component)
+{
+	if (FSkeletalMeshBodyShapeCache* BodyShapes = BodyShapeCaches.Find(&Component))
+		BodyShapes->Invalidate();
+}
+
+bool USkeletalMeshSweepSubsystem::ShouldUseProxy(const USkeletalMeshComponent& Component, const FVector& Start, float ProxyDistance) const
+{
+	if (!bHasCollisionLODOrigin)
+		return false;
+
+	const float Distance = ProxyDistance >= 0.f ? ProxyDistance : ChannelProxyDistances[Component.GetCollisionObjectType()];
+	return Distance < MAX_flt && FVector::DistSquared(Start, CollisionLODOrigin) >= FMath::Square(Distance);
+}
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "ComponentSweepStats.h"
+#include "Engine/EngineTypes.h"
+#include "SkeletalMeshBodyShapeCache.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SweepCapture.h"
+#include "SkeletalMeshSweepSubsystem.generated.h"
+
+class UPhysicsAsset;
+class USkeletalMesh;
+class USkeletalMeshComponent;
+
+/**
+ * Component sweeps for skeletal mesh components, using the body shapes cached per component by
+ * FSkeletalMeshBodyShapeCache instead of composing the pose with the physics asset on every query.
+ *
+ * Sweeps that start far enough from the collision LOD origin, typically the view, can sweep a proxy instead: one
+ * box fitted to the bounds of the physics asset in the ref pose of the mesh, oriented with the component. That is
+ * enough for far queries such as visibility checks or coarse avoidance, and costs one shape whatever the number
+ * of bodies. The distance is set per collision channel, or per query.
+ *
+ * Everything but the static functions is game thread only, since queries update the caches, scratch arrays and
+ * stats of the subsystem; worker threads sweep skeletal meshes through UAsyncComponentSweepSubsystem instead.
+ *
+ * While a sweep capture is running, every sweep made through the subsystem or through FReusableComponentSweep
+ * is recorded, so that it can be replayed with FSweepCaptureReplay. The SweepCapture.Begin and SweepCapture.End
+ * console commands run one in the current world.
+ */
+UCLASS()
+class SKELETALMESHCOLLIDER_API USkeletalMeshSweepSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Same contract as UWorld::ComponentSweepMulti: sweeps every body shape of Component from Start to End with
+	 * rotation Rot, and returns the hits sorted by time, with the blocking hit (if any) last. ProxyDistance
+	 * overrides the proxy distance of the collision object type of Component when it isn't negative.
+	 */
+	bool ComponentSweepMulti(TArray<FHitResult>& OutHits, USkeletalMeshComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, float ProxyDistance = -1.f);
+
+	/** Sweeps of components of object type Channel that start at least Distance from the LOD origin use the proxy. */
+	void SetProxyDistance(ECollisionChannel Channel, float Distance);
+	float GetProxyDistance(ECollisionChannel Channel) const { return ChannelProxyDistances[Channel]; }
+
+	/** Point the proxy distances are measured from; no sweep uses the proxy until it is set. */
+	void SetCollisionLODOrigin(const FVector& Origin);
+	void ClearCollisionLODOrigin() { bHasCollisionLODOrigin = false; }
+
+	/** The proxy box of Component, relative to it and scaled with it; false if it has no physics asset. */
+	bool GetProxyShape(const USkeletalMeshComponent& Component, FCachedBodyShape& OutShape);
+
+	/** Returns the body shapes of Component, updating them first if its pose has changed. */
+	const FSkeletalMeshBodyShapeCache& GetBodyShapes(const USkeletalMeshComponent& Component);
+
+	/** Makes the next query of Component rebuild its body shapes, as if they had never been cached. */
+	void InvalidateBodyShapes(const USkeletalMeshComponent& Component);
+
+	/**
+	 * The collision shape of a shape component followed by those of the shape components welded into its body,
+	 * relative to it, which UWorld::ComponentSweepMulti sweeps too; false if Component is not a shape component with
+	 * a body, or something other than a shape component is welded to it.
+	 */
+	static bool GetWeldedShapes(const UPrimitiveComponent& Component, TArray<FCachedBodyShape>& OutShapes);
+
+	/** World transforms at the start of the sweep of every shape, for a component that starts at Start with rotation Rot. */
+	static void GetShapeStarts(TArrayView<const FCachedBodyShape> Shapes, const FVector& Start, const FQuat& Rot, TArray<FTransform>& OutShapeStarts);
+
+	/**
+	 * Sweeps every shape from its start by End - Start and appends the hits to OutHits, unsorted, with the location,
+	 * trace and bone of the component rather than those of the shape. Safe to call from any thread.
+	 */
+	static void SweepShapes(const UWorld& World, TArrayView<const FCachedBodyShape> Shapes, TArrayView<const FTransform> ShapeStarts, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, const FComponentQueryParams& Params, const FCollisionResponseParams& ResponseParams, TArray<FHitResult>& ScratchHits, TArray<FHitResult>& OutHits);
+
+	/** Sorts hits by time and drops everything after the first blocking hit; returns true if there is one. */
+	static bool FinalizeSweepHits(TArray<FHitResult>& Hits);
+
+	/** Counters and phase times of the last ComponentSweepMulti. */
+	const FComponentSweepStats& GetLastSweepStats() const { return LastSweepStats; }
+
+	/** Starts recording sweeps, discarding those of a capture that is already running. */
+	void BeginSweepCapture();
+	/** Stops recording sweeps and saves them to Path; false if no capture was running or it couldn't be saved. */
+	bool EndSweepCapture(const FString& Path);
+	/** The running capture, or null if sweeps aren't being recorded. */
+	FSweepCaptureWriter* GetSweepCapture() const { return SweepCapture.Get(); }
+
+private:
+	bool SweepComponent(TArray<FHitResult>& OutHits, USkeletalMeshComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, float ProxyDistance);
+	bool ShouldUseProxy(const USkeletalMeshComponent& Component, const FVector& Start, float ProxyDistance) const;
+
+	TMap<TWeakObjectPtr<const USkeletalMeshComponent>, FSkeletalMeshBodyShapeCache> BodyShapeCaches;
+	/** Unscaled component space bounds of the ref pose bodies, per mesh and physics asset. */
+	TMap<TPair<TWeakObjectPtr<const USkeletalMesh>, TWeakObjectPtr<const UPhysicsAsset>>, FBox> RefPoseBounds;
+	float ChannelProxyDistances[ECC_MAX];
+	FVector CollisionLODOrigin = FVector::ZeroVector;
+	bool bHasCollisionLODOrigin = false;
+	/** Caches of destroyed components are dropped when the map grows past this size. */
+	int32 NextStaleCachePruneNum = 64;
+	TArray<FHitResult> ShapeHits;
+	/** World transforms of the shapes at the start of the sweep. */
+	TArray<FTransform> ShapeStarts;
+	FComponentSweepStats LastSweepStats;
+	TUniquePtr<FSweepCaptureWriter> SweepCapture;
+};
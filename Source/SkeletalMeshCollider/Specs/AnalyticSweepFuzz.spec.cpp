@@ -0,0 +1,347 @@
+#include "AnalyticSweep.h"
+#include "Async/ParallelFor.h"
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+namespace
+{
+	struct FSweepFuzzQuery
+	{
+		bool bSphere = false;
+		FAnalyticBox MovingBox;
+		float SphereRadius = 0.f;
+		FVector Start = FVector::ZeroVector;
+		FVector End = FVector::ZeroVector;
+		int32 TargetIndex = 0;
+	};
+
+	struct FSweepFuzzSettings
+	{
+		int32 NumQueries = 20000;
+		int32 Seed = 0x5EED;
+		float Tolerance = 0.5f;
+		int32 MaxReportedDivergences = 10;
+
+		FSweepFuzzSettings()
+		{
+			FParse::Value(FCommandLine::Get(), TEXT("SweepFuzzQueries="), NumQueries);
+			FParse::Value(FCommandLine::Get(), TEXT("SweepFuzzSeed="), Seed);
+			FParse::Value(FCommandLine::Get(), TEXT("SweepFuzzTolerance="), Tolerance);
+		}
+	};
+
+	const int32 QueriesPerBlock = 8192;
+	const int32 QueriesPerChunk = 256;
+
+	FQuat RandomRotation(FRandomStream& Random)
+	{
+		return FRotator{ Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f) }.Quaternion();
+	}
+
+	/** A box or sphere sweep that starts up to ReachRadius away from TargetCenter and passes close to it. */
+	FSweepFuzzQuery MakeRandomQuery(FRandomStream& Random, const FVector& TargetCenter, int32 TargetIndex)
+	{
+		const float ReachRadius = 800.f;
+		const float AimJitter = 300.f;
+
+		FSweepFuzzQuery Query;
+		Query.TargetIndex = TargetIndex;
+		Query.bSphere = Random.FRand() < 0.5f;
+		Query.Start = TargetCenter + Random.GetUnitVector() * Random.FRandRange(0.25f, 1.f) * ReachRadius;
+		const FVector Aim = TargetCenter + Random.GetUnitVector() * Random.FRandRange(0.f, AimJitter);
+		Query.End = Query.Start + (Aim - Query.Start) * Random.FRandRange(0.5f, 2.f);
+
+		if (Query.bSphere)
+			Query.SphereRadius = Random.FRandRange(5.f, 150.f);
+		else
+		{
+			Query.MovingBox.Center = Query.Start;
+			Query.MovingBox.Rotation = RandomRotation(Random);
+			Query.MovingBox.HalfExtents = FVector{ Random.FRandRange(5.f, 150.f), Random.FRandRange(5.f, 150.f), Random.FRandRange(5.f, 150.f) };
+		}
+		return Query;
+	}
+
+	FAnalyticBox InflateBox(const FAnalyticBox& Box, float Amount)
+	{
+		FAnalyticBox Inflated = Box;
+		Inflated.HalfExtents = (Box.HalfExtents + FVector{ Amount }).ComponentMax(FVector{ KINDA_SMALL_NUMBER });
+		return Inflated;
+	}
+
+	void SweepOracle(TArrayView<const FSweepFuzzQuery> Queries, TArrayView<const FAnalyticBox> Targets, float Inflation, TArray<FAnalyticSweepHit>& OutHits)
+	{
+		TArray<FAnalyticBox> MovingBoxes, BoxTargets;
+		TArray<FVector> BoxDeltas, SphereCenters, SphereDeltas;
+		TArray<float> SphereRadii;
+		TArray<FAnalyticBox> SphereTargets;
+		for (const FSweepFuzzQuery& Query : Queries)
+		{
+			const FAnalyticBox Target = InflateBox(Targets[Query.TargetIndex], Inflation);
+			if (Query.bSphere)
+			{
+				SphereCenters.Add(Query.Start);
+				SphereRadii.Add(Query.SphereRadius);
+				SphereDeltas.Add(Query.End - Query.Start);
+				SphereTargets.Add(Target);
+			}
+			else
+			{
+				MovingBoxes.Add(Query.MovingBox);
+				BoxDeltas.Add(Query.End - Query.Start);
+				BoxTargets.Add(Target);
+			}
+		}
+
+		TArray<FAnalyticSweepHit> BoxHits, SphereHits;
+		BoxHits.SetNum(MovingBoxes.Num());
+		SphereHits.SetNum(SphereCenters.Num());
+		FAnalyticSweep::SweepBoxesAgainstBoxes(MovingBoxes, BoxDeltas, BoxTargets, BoxHits);
+		FAnalyticSweep::SweepSpheresAgainstBoxes(SphereCenters, SphereRadii, SphereDeltas, SphereTargets, SphereHits);
+
+		OutHits.Reset(Queries.Num());
+		int32 BoxIndex = 0, SphereIndex = 0;
+		for (const FSweepFuzzQuery& Query : Queries)
+			OutHits.Add(Query.bSphere ? SphereHits[SphereIndex++] : BoxHits[BoxIndex++]);
+	}
+
+	/**
+	 * Sweeps every query through the physics engine and through the oracle, on all worker threads, and returns
+	 * a description of each query where they disagree.
+	 *
+	 * The oracle runs against the target inflated and deflated by Tolerance, which brackets the result the engine
+	 * may legitimately return: it must hit the inflated target no later than it hits the actual one, and must not
+	 * miss when the deflated target is hit.
+	 */
+	TArray<FString> FindSweepDivergences(const UWorld* World, const FCollisionQueryParams& Params, TArrayView<const FSweepFuzzQuery> Queries, TArrayView<const FAnalyticBox> Targets, float Tolerance)
+	{
+		const int32 NumChunks = FMath::DivideAndRoundUp(Queries.Num(), QueriesPerChunk);
+		TArray<TArray<FString>> ChunkDivergences;
+		ChunkDivergences.SetNum(NumChunks);
+
+		ParallelFor(NumChunks, [&](int32 ChunkIndex)
+			{
+				const int32 First = ChunkIndex * QueriesPerChunk;
+				const TArrayView<const FSweepFuzzQuery> ChunkQueries = Queries.Slice(First, FMath::Min(QueriesPerChunk, Queries.Num() - First));
+
+				TArray<FAnalyticSweepHit> InflatedHits, DeflatedHits;
+				SweepOracle(ChunkQueries, Targets, Tolerance, InflatedHits);
+				SweepOracle(ChunkQueries, Targets, -Tolerance, DeflatedHits);
+
+				for (int32 Index = 0; Index < ChunkQueries.Num(); Index++)
+				{
+					const FSweepFuzzQuery& Query = ChunkQueries[Index];
+					const FCollisionShape Shape = Query.bSphere ? FCollisionShape::MakeSphere(Query.SphereRadius) : FCollisionShape::MakeBox(Query.MovingBox.HalfExtents);
+					const FQuat Rotation = Query.bSphere ? FQuat::Identity : Query.MovingBox.Rotation;
+
+					FHitResult EngineHit;
+					const bool bEngineHit = World->SweepSingleByChannel(EngineHit, Query.Start, Query.End, Rotation, ECollisionChannel::ECC_Visibility, Shape, Params);
+
+					const float SweepLength = (Query.End - Query.Start).Size();
+					const float EarliestDistance = InflatedHits[Index].Time * SweepLength - Tolerance;
+					const float LatestDistance = DeflatedHits[Index].bBlockingHit ? DeflatedHits[Index].Time * SweepLength + Tolerance : SweepLength;
+
+					FString Divergence;
+					if (bEngineHit && !InflatedHits[Index].bBlockingHit)
+						Divergence = TEXT("engine hit, oracle misses");
+					else if (!bEngineHit && DeflatedHits[Index].bBlockingHit)
+						Divergence = FString::Printf(TEXT("engine misses, oracle hits at distance %f"), DeflatedHits[Index].Time * SweepLength);
+					else if (bEngineHit && (EngineHit.Distance < EarliestDistance || EngineHit.Distance > LatestDistance))
+						Divergence = FString::Printf(TEXT("engine distance %f outside oracle range [%f, %f]"), EngineHit.Distance, EarliestDistance, LatestDistance);
+
+					if (!Divergence.IsEmpty())
+					{
+						const FAnalyticBox& Target = Targets[Query.TargetIndex];
+						ChunkDivergences[ChunkIndex].Add(FString::Printf(TEXT("Query %d (%s, start %s, end %s, rotation %s, extent %s) against box (center %s, rotation %s, extent %s): %s"),
+							First + Index, Query.bSphere ? *FString::Printf(TEXT("sphere radius %f"), Query.SphereRadius) : TEXT("box"),
+							*Query.Start.ToString(), *Query.End.ToString(), *Rotation.ToString(), *Query.MovingBox.HalfExtents.ToString(),
+							*Target.Center.ToString(), *Target.Rotation.ToString(), *Target.HalfExtents.ToString(), *Divergence));
+					}
+				}
+			});
+
+		TArray<FString> Divergences;
+		for (TArray<FString>& Chunk : ChunkDivergences)
+			Divergences.Append(MoveTemp(Chunk));
+		return Divergences;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FAnalyticSweepFuzzSpec, "ComponentCollision.Fuzz", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+	FSweepFuzzSettings Settings;
+
+	void ReportDivergences(const TArray<FString>& Divergences, int32 NumQueries, double Seconds);
+END_DEFINE_COMPONENT_COLLISION_SPEC(FAnalyticSweepFuzzSpec)
+
+void FAnalyticSweepFuzzSpec::ReportDivergences(const TArray<FString>& Divergences, int32 NumQueries, double Seconds)
+{
+	AddInfo(FString::Printf(TEXT("%d queries with seed %d in %.2f s (%.0f queries/s), %d divergences"), NumQueries, Settings.Seed, Seconds, NumQueries / FMath::Max(Seconds, 1e-6), Divergences.Num()));
+	for (int32 Index = 0; Index < FMath::Min(Divergences.Num(), Settings.MaxReportedDivergences); Index++)
+		AddError(Divergences[Index]);
+}
+
+void FAnalyticSweepFuzzSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("Fuzz")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("FAnalyticSweep", [this]()
+		{
+			It("reproduces the hand-derived distances of the axis-aligned sweeps", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+						FAnalyticBox Floor;
+						Floor.Center = FVector{ 0, 0, -281.f };
+						Floor.HalfExtents = FVector{ 1000, 1000, 1.f };
+						const float FloorTopZ = Floor.Center.Z + Floor.HalfExtents.Z;
+
+						const FAnalyticSweepHit SphereHit = FAnalyticSweep::SweepSphereAgainstBox(SweepStart, 100.f, SweepEnd - SweepStart, Floor);
+						TEST_TRUE_THROW(SphereHit.bBlockingHit);
+						TEST_EQUAL_TOLERANCE_THROW(SphereHit.ImpactPoint.Z, FloorTopZ, 0.1f);
+						TEST_EQUAL_TOLERANCE_THROW(SphereHit.Time * 2000.f, SweepStart.Z - FloorTopZ - 100.f, 0.1f);
+						TEST_EQUAL_TOLERANCE_THROW(SphereHit.ImpactNormal, FVector::UpVector, 0.01f);
+
+						for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+						{
+							FAnalyticBox Cube;
+							Cube.Center = SweepStart;
+							Cube.HalfExtents = FVector{ Variant.GetCubeHalfZExtent() };
+							const FAnalyticSweepHit BoxHit = FAnalyticSweep::SweepBoxAgainstBox(Cube, SweepEnd - SweepStart, Floor);
+							TEST_TRUE_THROW(BoxHit.bBlockingHit);
+							TEST_EQUAL_TOLERANCE_THROW(BoxHit.Time * 2000.f, SweepStart.Z - FloorTopZ - Variant.GetCubeHalfZExtent(), 0.1f);
+							TEST_EQUAL_TOLERANCE_THROW(BoxHit.ImpactNormal, FVector::UpVector, 0.01f);
+						}
+
+						FAnalyticBox LowerCube;
+						LowerCube.Center = FVector{ 0, 0, -100.f };
+						LowerCube.HalfExtents = FVector{ 50.f };
+						FAnalyticBox UpperCube;
+						UpperCube.Center = FVector{ 0, 0, 50.f };
+						UpperCube.HalfExtents = FVector{ 50.f };
+						const float ObstacleMaxZ = 100.f;
+						const float ObstacleMinZ = -150.f;
+						FAnalyticBox FloorFromAbove = Floor;
+						FloorFromAbove.Center = SweepStart;
+						TEST_EQUAL_TOLERANCE_THROW(FAnalyticSweep::SweepBoxAgainstBox(FloorFromAbove, SweepEnd - SweepStart, UpperCube).Time * 2000.f, SweepStart.Z - Floor.HalfExtents.Z - ObstacleMaxZ, 0.1f);
+						FAnalyticBox FloorFromBelow = Floor;
+						FloorFromBelow.Center = SweepEnd;
+						TEST_EQUAL_TOLERANCE_THROW(FAnalyticSweep::SweepBoxAgainstBox(FloorFromBelow, SweepStart - SweepEnd, LowerCube).Time * 2000.f, ObstacleMinZ - SweepEnd.Z - Floor.HalfExtents.Z, 0.1f);
+					}
+					catch (...) {}
+				});
+
+			It("agrees with the physics engine for random box and sphere sweeps against rotated, scaled UBoxComponents", [this]()
+				{
+					try {
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+						TEST_NOT_NULL_THROW(FloorPlaneCollider);
+						UBoxComponent* TargetCollider = CreatePrimitiveCollider<UBoxComponent>(World);
+						TEST_NOT_NULL_THROW(TargetCollider);
+
+						FCollisionQueryParams Params;
+						Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+
+						FRandomStream Random(Settings.Seed);
+						TArray<FString> Divergences;
+						TArray<FSweepFuzzQuery> Queries;
+						Fixture.BeginSweeps();
+						const double StartSeconds = FPlatformTime::Seconds();
+						for (int32 FirstQuery = 0; FirstQuery < Settings.NumQueries; FirstQuery += QueriesPerBlock)
+						{
+							TargetCollider->SetBoxExtent(FVector{ Random.FRandRange(20.f, 200.f), Random.FRandRange(20.f, 200.f), Random.FRandRange(20.f, 200.f) });
+							TargetCollider->SetWorldRotation(RandomRotation(Random));
+							TargetCollider->SetWorldScale3D(FVector{ Random.FRandRange(0.5f, 2.f), Random.FRandRange(0.5f, 2.f), Random.FRandRange(0.5f, 2.f) });
+
+							FAnalyticBox Target;
+							Target.Center = TargetCollider->GetComponentLocation();
+							Target.Rotation = TargetCollider->GetComponentQuat();
+							Target.HalfExtents = TargetCollider->GetScaledBoxExtent();
+
+							Queries.Reset();
+							for (int32 Index = FirstQuery; Index < FMath::Min(FirstQuery + QueriesPerBlock, Settings.NumQueries); Index++)
+								Queries.Add(MakeRandomQuery(Random, Target.Center, 0));
+							Divergences.Append(FindSweepDivergences(World, Params, Queries, MakeArrayView(&Target, 1), Settings.Tolerance));
+						}
+						ReportDivergences(Divergences, Settings.NumQueries, FPlatformTime::Seconds() - StartSeconds);
+					}
+					catch (...) {}
+				});
+
+			It("agrees with the physics engine for random box and sphere sweeps against rotated, scaled ref pose cubes", [this]()
+				{
+					try {
+						const float CubeSpacing = 4000.f;
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+						TEST_NOT_NULL_THROW(FloorPlaneCollider);
+						auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+
+						TArray<USkeletalMeshComponent*> Components;
+						for (int32 VariantIndex = 0; VariantIndex < UE_ARRAY_COUNT(RefPoseCubeVariants); VariantIndex++)
+						{
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[VariantIndex], FVector{ VariantIndex * CubeSpacing, 0, 2000.f });
+							TEST_NOT_NULL_THROW(Component);
+							Component->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+							Components.Add(Component);
+						}
+
+						FCollisionQueryParams Params;
+						Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+
+						FRandomStream Random(Settings.Seed);
+						TArray<FString> Divergences;
+						TArray<FSweepFuzzQuery> Queries;
+						TArray<FAnalyticBox> Targets;
+						Fixture.BeginSweeps();
+						const double StartSeconds = FPlatformTime::Seconds();
+						for (int32 FirstQuery = 0; FirstQuery < Settings.NumQueries; FirstQuery += QueriesPerBlock)
+						{
+							Targets.Reset();
+							for (USkeletalMeshComponent* Component : Components)
+							{
+								Component->GetOwner()->SetActorRotation(RandomRotation(Random));
+								Component->GetOwner()->SetActorScale3D(FVector{ Random.FRandRange(0.5f, 1.5f) });
+
+								const FSkeletalMeshBodyShapeCache& BodyShapes = Subsystem->GetBodyShapes(*Component);
+								TEST_EQUAL_THROW(BodyShapes.GetShapes().Num(), 1);
+								const FCachedBodyShape& BodyShape = BodyShapes.GetShapes()[0];
+								TEST_TRUE_THROW(BodyShape.Shape.IsBox());
+
+								FAnalyticBox& Target = Targets.AddDefaulted_GetRef();
+								Target.Center = Component->GetComponentLocation() + Component->GetComponentQuat().RotateVector(BodyShape.ShapeToComponent.GetLocation());
+								Target.Rotation = Component->GetComponentQuat() * BodyShape.ShapeToComponent.GetRotation();
+								Target.HalfExtents = BodyShape.Shape.GetBox();
+							}
+
+							Queries.Reset();
+							for (int32 Index = FirstQuery; Index < FMath::Min(FirstQuery + QueriesPerBlock, Settings.NumQueries); Index++)
+							{
+								const int32 TargetIndex = Random.RandHelper(Targets.Num());
+								Queries.Add(MakeRandomQuery(Random, Targets[TargetIndex].Center, TargetIndex));
+							}
+							Divergences.Append(FindSweepDivergences(World, Params, Queries, Targets, Settings.Tolerance));
+						}
+						ReportDivergences(Divergences, Settings.NumQueries, FPlatformTime::Seconds() - StartSeconds);
+					}
+					catch (...) {}
+				});
+		});
+}
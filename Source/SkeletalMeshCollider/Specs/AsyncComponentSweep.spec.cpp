@@ -0,0 +1,198 @@
+#include "AsyncComponentSweepSubsystem.h"
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(FAsyncComponentSweepSpec, "ComponentCollision.AsyncSweep", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+
+	/** Runs the async sweep across a simulated frame boundary and compares it with UWorld::ComponentSweepMulti. */
+	void TestMatchesSyncSweep(UWorld* World, UPrimitiveComponent* Component, const FVector& SweepStart, const FVector& SweepEnd, const FComponentQueryParams& Params);
+	TArray<UBoxComponent*> SpawnBoxPair(UWorld* World, bool bWelded);
+END_DEFINE_COMPONENT_COLLISION_SPEC(FAsyncComponentSweepSpec)
+
+void FAsyncComponentSweepSpec::TestMatchesSyncSweep(UWorld* World, UPrimitiveComponent* Component, const FVector& SweepStart, const FVector& SweepEnd, const FComponentQueryParams& Params)
+{
+	auto Subsystem = World->GetSubsystem<UAsyncComponentSweepSubsystem>();
+	TEST_NOT_NULL_THROW(Subsystem);
+
+	TArray<FHitResult> SyncHits;
+	const bool bSyncBlockingHit = World->ComponentSweepMulti(SyncHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+
+	int32 NumDelegateCalls = 0;
+	const FComponentSweepDelegate Delegate = FComponentSweepDelegate::CreateLambda([&NumDelegateCalls](const FTraceHandle&, FComponentSweepDatum&) { NumDelegateCalls++; });
+	const FTraceHandle Handle = Subsystem->AsyncComponentSweepMulti(Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, &Delegate);
+	TEST_TRUE_THROW(Subsystem->IsComponentSweepHandleValid(Handle));
+
+	// The results arrive on the next frame, not in the frame of the request
+	FComponentSweepDatum Datum;
+	TEST_FALSE_THROW(Subsystem->QueryComponentSweepData(Handle, Datum));
+	Subsystem->StartAsyncSweeps();
+	TEST_FALSE_THROW(Subsystem->QueryComponentSweepData(Handle, Datum));
+	Subsystem->FinishAsyncSweeps();
+	TEST_EQUAL_THROW(NumDelegateCalls, 1);
+	TEST_TRUE_THROW(Subsystem->QueryComponentSweepData(Handle, Datum));
+
+	TEST_TRUE_THROW(Datum.bBlockingHit == bSyncBlockingHit);
+	TEST_EQUAL_THROW(Datum.OutHits.Num(), SyncHits.Num());
+	for (int32 HitIndex = 0; HitIndex < SyncHits.Num(); HitIndex++)
+	{
+		const FHitResult& AsyncHit = Datum.OutHits[HitIndex];
+		const FHitResult& SyncHit = SyncHits[HitIndex];
+		TEST_TRUE_THROW(AsyncHit.GetComponent() == SyncHit.GetComponent());
+		TEST_TRUE_THROW(AsyncHit.MyBoneName == SyncHit.MyBoneName);
+		TEST_TRUE_THROW(AsyncHit.bBlockingHit == SyncHit.bBlockingHit);
+		TEST_TRUE_THROW(AsyncHit.bStartPenetrating == SyncHit.bStartPenetrating);
+		TEST_EQUAL_TOLERANCE_THROW(AsyncHit.Distance, SyncHit.Distance, 0.1f);
+		TEST_EQUAL_TOLERANCE_THROW(AsyncHit.Location, SyncHit.Location, 0.1f);
+		TEST_EQUAL_TOLERANCE_THROW(AsyncHit.ImpactPoint, SyncHit.ImpactPoint, 0.1f);
+		TEST_EQUAL_TOLERANCE_THROW(AsyncHit.ImpactNormal, SyncHit.ImpactNormal, 0.01f);
+	}
+
+	// Only during that frame
+	Subsystem->StartAsyncSweeps();
+	Subsystem->FinishAsyncSweeps();
+	TEST_FALSE_THROW(Subsystem->QueryComponentSweepData(Handle, Datum));
+	TEST_EQUAL_THROW(NumDelegateCalls, 1);
+}
+
+TArray<UBoxComponent*> FAsyncComponentSweepSpec::SpawnBoxPair(UWorld* World, bool bWelded)
+{
+	auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+	TEST_NOT_NULL_THROW(ActorClass);
+	auto Actor = World->SpawnActor<AActor>(ActorClass);
+	TEST_NOT_NULL_THROW(Actor);
+	TArray<UBoxComponent*> Boxes;
+	Actor->GetComponents(Boxes);
+	TEST_EQUAL_THROW(Boxes.Num(), 2);
+	TEST_NOT_NULL_THROW(Boxes[0]);
+	TEST_NOT_NULL_THROW(Boxes[1]);
+	if (bWelded)
+		Boxes[1]->WeldTo(Boxes[0]);
+	return Boxes;
+}
+
+void FAsyncComponentSweepSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("AsyncSweep")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("UAsyncComponentSweepSubsystem::AsyncComponentSweepMulti", [this]()
+		{
+			It("USphereComponent Sweep hits the floor from above like the synchronous sweep", [this]()
+				{
+					try {
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						TEST_NOT_NULL_THROW(Fixture.GetFloor());
+						USphereComponent* Component = CreatePrimitiveCollider<USphereComponent>(World);
+						TEST_NOT_NULL_THROW(Component);
+						Component->SetSphereRadius(100.f);
+
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Component->GetOwner());
+						Fixture.BeginSweeps();
+						TestMatchesSyncSweep(World, Component, FVector{ 0, 0, 1000.f }, FVector{ 0, 0, -1000.f }, Params);
+					}
+					catch (...) {}
+				});
+
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("USkeletalMeshComponent (%s) Sweep hits the floor from above like the synchronous sweep"), Variant.Name), [this, Variant]()
+					{
+						try {
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							TEST_NOT_NULL_THROW(Fixture.GetFloor());
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(Component);
+
+							FComponentQueryParams Params;
+							Params.AddIgnoredActor(Component->GetOwner());
+							Fixture.BeginSweeps();
+							TestMatchesSyncSweep(World, Component, FVector{ 0, 0, 1000.f }, FVector{ 0, 0, -1000.f }, Params);
+						}
+						catch (...) {}
+					});
+			}
+
+			for (const bool bWelded : { false, true })
+			{
+				for (const float SweepStartZ : { 1000.f, -1000.f })
+				{
+					It(FString::Printf(TEXT("Floor hits UBoxCollider pair from %s%s like the synchronous sweep"), SweepStartZ > 0.f ? TEXT("above") : TEXT("below"), bWelded ? TEXT(" (runtime-welded)") : TEXT("")), [this, bWelded, SweepStartZ]()
+						{
+							try {
+								UWorld* World = Fixture.GetWorld();
+								TEST_NOT_NULL_THROW(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+								TEST_NOT_NULL_THROW(FloorPlaneCollider);
+								SpawnBoxPair(World, bWelded);
+
+								FComponentQueryParams Params;
+								Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+								Fixture.BeginSweeps();
+								TestMatchesSyncSweep(World, FloorPlaneCollider, FVector{ 0, 0, SweepStartZ }, FVector{ 0, 0, -SweepStartZ }, Params);
+							}
+							catch (...) {}
+						});
+				}
+
+				It(FString::Printf(TEXT("UBoxCollider pair%s Sweep hits the floor from above like the synchronous sweep"), bWelded ? TEXT(" (runtime-welded)") : TEXT("")), [this, bWelded]()
+					{
+						try {
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							TEST_NOT_NULL_THROW(Fixture.GetFloor());
+							const TArray<UBoxComponent*> Boxes = SpawnBoxPair(World, bWelded);
+
+							FComponentQueryParams Params;
+							Params.AddIgnoredActor(Boxes[0]->GetOwner());
+							Fixture.BeginSweeps();
+							TestMatchesSyncSweep(World, Boxes[0], FVector{ 0, 0, 1000.f }, FVector{ 0, 0, -1000.f }, Params);
+						}
+						catch (...) {}
+					});
+			}
+
+			It("delivers the results of a USkeletalMeshComponent destroyed after the request", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+						TEST_NOT_NULL_THROW(FloorPlaneCollider);
+						auto Subsystem = World->GetSubsystem<UAsyncComponentSweepSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+						TEST_NOT_NULL_THROW(Component);
+
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Component->GetOwner());
+						Fixture.BeginSweeps();
+						const FTraceHandle Handle = Subsystem->AsyncComponentSweepMulti(Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+						Component->GetOwner()->Destroy();
+						Subsystem->StartAsyncSweeps();
+						Subsystem->FinishAsyncSweeps();
+
+						FComponentSweepDatum Datum;
+						TEST_TRUE_THROW(Subsystem->QueryComponentSweepData(Handle, Datum));
+						TEST_TRUE_THROW(Datum.bBlockingHit);
+						TEST_TRUE_THROW(Datum.OutHits.Last().GetComponent() == FloorPlaneCollider);
+						TEST_EQUAL_TOLERANCE_THROW(Datum.OutHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
+					}
+					catch (...) {}
+				});
+		});
+}
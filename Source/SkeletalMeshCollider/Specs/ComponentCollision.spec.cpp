@@ -1,109 +1,28 @@
 #include "Animation/SkeletalMeshActor.h"
 #include "AutomationEditorCommon.h"
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
 #include "Components/BoxComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "ComponentWeldBatch.h"
 #include "CoreMinimal.h"
-#include "Engine/CollisionProfile.h"
 #include "Engine/World.h"
 #include "Misc/AutomationTest.h"
 
-#define TEST_TRUE_THROW(expression) \
-	do { if (!(expression)) { AddError(TEXT("Expected '") TEXT(#expression) TEXT("' to be true."), 0); throw 0; } } while (0)
-
-#define TEST_FALSE_THROW(expression) \
-	do { if ((expression)) { AddError(TEXT("Expected '") TEXT(#expression) TEXT("' to be false."), 0); throw 0; } } while (0)
-
-#define TEST_NOT_NULL_THROW(expression) \
-	do { if (!(expression)) { AddError(TEXT("Expected '") TEXT(#expression) TEXT("' to be not null."), 0); throw 0; } } while (0)
-
-#define TEST_EQUAL_THROW(expression, expected) \
-	do { if ((expression) != (expected)) { AddError(FString::Printf(TEXT("%s%d"), TEXT("Expected ") TEXT(#expression) TEXT(" to be equal to ") TEXT(#expected) TEXT(", but it was "), (expression)), 0); throw 0; } } while (0)
-
-template <typename T>
-FString ToString(const T& object);
-
-template <>
-FString ToString(const FVector& object)
-{
-	return object.ToString();
-}
-
-template <>
-FString ToString(const int& value)
-{
-	return FString::Printf(TEXT("%d"), value);
-}
-
-template <>
-FString ToString(const float& value)
-{
-	return FString::Printf(TEXT("%f"), value);
-}
-
-
-template <typename T>
-bool TestEqualWithToleranceComparison(const T& a, const T& b, float Tolerance);
-
-template <>
-bool TestEqualWithToleranceComparison(const FVector& a, const FVector& b, const float Tolerance)
-{
-	return a.Equals(b, Tolerance);
-}
-
-template <>
-bool TestEqualWithToleranceComparison(const int& a, const int& b, const float Tolerance)
-{
-	return FMath::IsNearlyEqual(a, b, Tolerance);
-}
-
-template <>
-bool TestEqualWithToleranceComparison(const float& a, const float& b, const float Tolerance)
-{
-	return FMath::IsNearlyEqual(a, b, Tolerance);
-}
-
-#define TEST_EQUAL_TOLERANCE_THROW(expression, expected, tolerance) \
-	do { if (!TestEqualWithToleranceComparison((expression), (expected), (tolerance))) { AddError(FString::Printf(TEXT("Expected ") TEXT(#expression) TEXT(" to be equal to %s but it was %s"), *ToString(expected), *ToString(expression)), 0); throw 0; } } while (0)
-
-UWorld* CreateWorld()
-{
-	auto World = FAutomationEditorCommonUtils::CreateNewMap();
-	check(World);
-	return World;
-}
+BEGIN_DEFINE_SPEC(FComponentSweepSpec, "ComponentCollision", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
 
-UBoxComponent* CreateFloor(UWorld* World)
-{
-	auto FloorPlane = World->SpawnActor<AActor>();
-	check(FloorPlane);
-	auto FloorPlaneCollider = NewObject<UBoxComponent>(FloorPlane, UBoxComponent::StaticClass(), TEXT("FloorPlaneCollider"));
-	check(FloorPlaneCollider);
-	FloorPlaneCollider->RegisterComponent();
-	FloorPlaneCollider->SetWorldLocation(FVector{ 0, 0, -281.f });
-	FloorPlaneCollider->SetBoxExtent(FVector{ 1000, 1000, 1.f });
-	FloorPlaneCollider->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
-	FloorPlaneCollider->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-
-	return FloorPlaneCollider;
-}
+	void UsePooledWorld(const FString& Scope);
+END_DEFINE_COMPONENT_COLLISION_SPEC(FComponentSweepSpec)
 
-template <class ComponentType>
-ComponentType* CreatePrimitiveCollider(UWorld* World)
+void FComponentSweepSpec::UsePooledWorld(const FString& Scope)
 {
-	auto Actor = World->SpawnActor<AActor>();
-	check(Actor);
-	auto Component = NewObject<ComponentType>(Actor, ComponentType::StaticClass(), TEXT("Collider"));
-	check(Component);
-	Component->RegisterComponent();
-	Component->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
-	Component->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-
-	return Component;
+	BeforeEach([this, Scope]() { Fixture.BeginTest(Scope); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
 }
 
-BEGIN_DEFINE_SPEC(FComponentSweepSpec, "ComponentCollision", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
-END_DEFINE_SPEC(FComponentSweepSpec)
 void FComponentSweepSpec::Define()
 {
 	BeforeEach([this]() {
@@ -113,6 +32,8 @@ void FComponentSweepSpec::Define()
 		{
 			Describe("Sphere shape sweeps against UBoxComponent", [this]()
 			{
+				UsePooledWorld(TEXT("Sphere shape sweeps against UBoxComponent"));
+
 				It("Sphere Sweep hits the floor from above", [this]()
 					{
 						try {
@@ -120,14 +41,15 @@ void FComponentSweepSpec::Define()
 							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
 							const float SphereRadius = 100.f;
 
-							UWorld* World = CreateWorld();
+							UWorld* World = Fixture.GetWorld();
 							TEST_NOT_NULL_THROW(World);
-							UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+							UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 							TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
 							FHitResult OutHit;
 							FCollisionShape CollisionShape;
 							CollisionShape.SetSphere(SphereRadius);
+							Fixture.BeginSweeps();
 							bool HitFound = World->SweepSingleByChannel(OutHit, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), ECollisionChannel::ECC_Visibility, CollisionShape);
 							TEST_TRUE_THROW(HitFound);
 							TEST_EQUAL_TOLERANCE_THROW(OutHit.ImpactPoint.Z, FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z, 0.1f);
@@ -138,6 +60,8 @@ void FComponentSweepSpec::Define()
 
 			Describe("USphereComponent sweeps against UBoxComponent", [this]()
 				{
+					UsePooledWorld(TEXT("USphereComponent sweeps against UBoxComponent"));
+
 					It("USphereComponent Sweep hits the floor from above", [this]()
 					{
 						try {
@@ -145,9 +69,9 @@ void FComponentSweepSpec::Define()
 							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
 							const float SphereRadius = 100.f;
 
-							UWorld* World = CreateWorld();
+							UWorld* World = Fixture.GetWorld();
 							TEST_NOT_NULL_THROW(World);
-							UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+							UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 							TEST_NOT_NULL_THROW(FloorPlaneCollider);
 							USphereComponent* Component = CreatePrimitiveCollider<USphereComponent>(World);
 							TEST_NOT_NULL_THROW(Component);
@@ -156,6 +80,7 @@ void FComponentSweepSpec::Define()
 							TArray<FHitResult> OutHits;
 							FComponentQueryParams Params;
 							Params.AddIgnoredActor(Component->GetOwner());
+							Fixture.BeginSweeps();
 							bool HitFound = World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 							TEST_TRUE_THROW(HitFound);
 							TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z, 0.1f);
@@ -166,20 +91,21 @@ void FComponentSweepSpec::Define()
 
 			Describe("USkeletalMeshComponent sweeps against UBoxComponent", [this]()
 				{
+					UsePooledWorld(TEXT("USkeletalMeshComponent sweeps against UBoxComponent"));
 
 					It("USkeletalMeshComponent (box at origin, identity ref pose) Sweep hits the floor from above", [this]()
 						{
 							try {
 								const FVector SweepStart = FVector{ 0, 0, 1000.f };
 								const FVector SweepEnd = FVector{ 0, 0, -1000.f };
-								const float CubeHalfZExtent = 100.f;
+								const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[0];
 
-								UWorld* World = CreateWorld();
+								UWorld* World = Fixture.GetWorld();
 								TEST_NOT_NULL_THROW(World);
-								UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 								TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
-								auto ActorClass = ::LoadClass<ASkeletalMeshActor>(nullptr, TEXT("Blueprint'/Game/ComponentCollision/Cube-IdentityRefPose/BP_Cube-IdentityRefPose.BP_Cube-IdentityRefPose_C'"));
+								auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(TEXT("Blueprint'/Game/ComponentCollision/Cube-IdentityRefPose/BP_Cube-IdentityRefPose.BP_Cube-IdentityRefPose_C'"));
 								TEST_NOT_NULL_THROW(ActorClass);
 								auto Actor = World->SpawnActor<ASkeletalMeshActor>(ActorClass);
 								TEST_NOT_NULL_THROW(Actor);
@@ -189,10 +115,11 @@ void FComponentSweepSpec::Define()
 								TArray<FHitResult> OutHits;
 								FComponentQueryParams Params;
 								Params.AddIgnoredActor(Component->GetOwner());
+								Fixture.BeginSweeps();
 								bool HitFound = World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 								TEST_TRUE_THROW(HitFound);
 								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z, 0.1f);
-								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, SweepStart.Z - (FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z) - CubeHalfZExtent, 0.1f);
+								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
 							} catch (...) {}
 						});
 
@@ -201,14 +128,14 @@ void FComponentSweepSpec::Define()
 							try {
 								const FVector SweepStart = FVector{ 0, 0, 1000.f };
 								const FVector SweepEnd = FVector{ 0, 0, -1000.f };
-								const float CubeHalfZExtent = 100.f;
+								const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[1];
 
-								UWorld* World = CreateWorld();
+								UWorld* World = Fixture.GetWorld();
 								TEST_NOT_NULL_THROW(World);
-								UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 								TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
-								auto ActorClass = ::LoadClass<ASkeletalMeshActor>(nullptr, TEXT("Blueprint'/Game/ComponentCollision/Cube-RotatedRefPose/BP_Cube-RotatedRefPose.BP_Cube-RotatedRefPose_C'"));
+								auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(TEXT("Blueprint'/Game/ComponentCollision/Cube-RotatedRefPose/BP_Cube-RotatedRefPose.BP_Cube-RotatedRefPose_C'"));
 								TEST_NOT_NULL_THROW(ActorClass);
 								auto Actor = World->SpawnActor<ASkeletalMeshActor>(ActorClass);
 								TEST_NOT_NULL_THROW(Actor);
@@ -218,10 +145,11 @@ void FComponentSweepSpec::Define()
 								TArray<FHitResult> OutHits;
 								FComponentQueryParams Params;
 								Params.AddIgnoredActor(Component->GetOwner());
+								Fixture.BeginSweeps();
 								bool HitFound = World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 								TEST_TRUE_THROW(HitFound);
 								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z, 0.1f);
-								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, SweepStart.Z - (FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z) - CubeHalfZExtent, 0.1f);
+								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
 							}
 							catch (...) {}
 						});
@@ -231,14 +159,14 @@ void FComponentSweepSpec::Define()
 							try {
 								const FVector SweepStart = FVector{ 0, 0, 1000.f };
 								const FVector SweepEnd = FVector{ 0, 0, -1000.f };
-								const float CubeHalfZExtent = 200.f;
+								const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[2];
 
-								UWorld* World = CreateWorld();
+								UWorld* World = Fixture.GetWorld();
 								TEST_NOT_NULL_THROW(World);
-								UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 								TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
-								auto ActorClass = ::LoadClass<ASkeletalMeshActor>(nullptr, TEXT("Blueprint'/Game/ComponentCollision/Cube-ScaledRefPose/BP_Cube-ScaledRefPose.BP_Cube-ScaledRefPose_C'"));
+								auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(TEXT("Blueprint'/Game/ComponentCollision/Cube-ScaledRefPose/BP_Cube-ScaledRefPose.BP_Cube-ScaledRefPose_C'"));
 								TEST_NOT_NULL_THROW(ActorClass);
 								auto Actor = World->SpawnActor<ASkeletalMeshActor>(ActorClass);
 								TEST_NOT_NULL_THROW(Actor);
@@ -248,10 +176,11 @@ void FComponentSweepSpec::Define()
 								TArray<FHitResult> OutHits;
 								FComponentQueryParams Params;
 								Params.AddIgnoredActor(Component->GetOwner());
+								Fixture.BeginSweeps();
 								bool HitFound = World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 								TEST_TRUE_THROW(HitFound);
 								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z, 0.1f);
-								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, SweepStart.Z - (FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z) - CubeHalfZExtent, 0.1f);
+								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
 							}
 							catch (...) {}
 						});
@@ -261,14 +190,14 @@ void FComponentSweepSpec::Define()
 							try {
 								const FVector SweepStart = FVector{ 0, 0, 1000.f };
 								const FVector SweepEnd = FVector{ 0, 0, -1000.f };
-								const float CubeHalfZExtent = 200.f;
+								const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
 
-								UWorld* World = CreateWorld();
+								UWorld* World = Fixture.GetWorld();
 								TEST_NOT_NULL_THROW(World);
-								UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 								TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
-								auto ActorClass = ::LoadClass<ASkeletalMeshActor>(nullptr, TEXT("Blueprint'/Game/ComponentCollision/Cube-ScaledAndRotatedRefPose/BP_Cube-ScaledAndRotatedRefPose.BP_Cube-ScaledAndRotatedRefPose_C'"));
+								auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(TEXT("Blueprint'/Game/ComponentCollision/Cube-ScaledAndRotatedRefPose/BP_Cube-ScaledAndRotatedRefPose.BP_Cube-ScaledAndRotatedRefPose_C'"));
 								TEST_NOT_NULL_THROW(ActorClass);
 								auto Actor = World->SpawnActor<ASkeletalMeshActor>(ActorClass);
 								TEST_NOT_NULL_THROW(Actor);
@@ -278,10 +207,11 @@ void FComponentSweepSpec::Define()
 								TArray<FHitResult> OutHits;
 								FComponentQueryParams Params;
 								Params.AddIgnoredActor(Component->GetOwner());
+								Fixture.BeginSweeps();
 								bool HitFound = World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 								TEST_TRUE_THROW(HitFound);
 								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z, 0.1f);
-								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, SweepStart.Z - (FloorPlaneCollider->GetComponentLocation().Z + FloorPlaneCollider->GetScaledBoxExtent().Z) - CubeHalfZExtent, 0.1f);
+								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
 							}
 							catch (...) {}
 						});
@@ -289,6 +219,7 @@ void FComponentSweepSpec::Define()
 
 			Describe("UBoxComponent sweeps against runtime-welded UBoxComponents", [this]()
 				{
+					UsePooledWorld(TEXT("UBoxComponent sweeps against runtime-welded UBoxComponents"));
 
 					It("Floor hits UBoxCollider pair from above", [this]()
 						{
@@ -297,12 +228,12 @@ void FComponentSweepSpec::Define()
 								const FVector SweepEnd = FVector{ 0, 0, -1000.f };
 								const float ObstacleMaxZ = 100.f;
 
-								UWorld* World = CreateWorld();
+								UWorld* World = Fixture.GetWorld();
 								TEST_NOT_NULL_THROW(World);
-								UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 								TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
-								auto ActorClass = ::LoadClass<AActor>(nullptr, TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+								auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
 								TEST_NOT_NULL_THROW(ActorClass);
 								auto Actor = World->SpawnActor<AActor>(ActorClass);
 								TEST_NOT_NULL_THROW(Actor);
@@ -317,6 +248,7 @@ void FComponentSweepSpec::Define()
 								TArray<FHitResult> OutHits;
 								FComponentQueryParams Params;
 								Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+								Fixture.BeginSweeps();
 								bool HitFound = World->ComponentSweepMulti(OutHits, FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 								TEST_TRUE_THROW(HitFound);
 								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, ObstacleMaxZ, 0.1f);
@@ -332,12 +264,12 @@ void FComponentSweepSpec::Define()
 								const FVector SweepEnd = FVector{ 0, 0, 1000.f };
 								const float ObstacleMinZ = -150.f;
 
-								UWorld* World = CreateWorld();
+								UWorld* World = Fixture.GetWorld();
 								TEST_NOT_NULL_THROW(World);
-								UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 								TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
-								auto ActorClass = ::LoadClass<AActor>(nullptr, TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+								auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
 								TEST_NOT_NULL_THROW(ActorClass);
 								auto Actor = World->SpawnActor<AActor>(ActorClass);
 								TEST_NOT_NULL_THROW(Actor);
@@ -352,6 +284,7 @@ void FComponentSweepSpec::Define()
 								TArray<FHitResult> OutHits;
 								FComponentQueryParams Params;
 								Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+								Fixture.BeginSweeps();
 								bool HitFound = World->ComponentSweepMulti(OutHits, FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 								TEST_TRUE_THROW(HitFound);
 								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, ObstacleMinZ, 0.1f);
@@ -367,12 +300,12 @@ void FComponentSweepSpec::Define()
 								const FVector SweepEnd = FVector{ 0, 0, -1000.f };
 								const float ObstacleMaxZ = 100.f;
 
-								UWorld* World = CreateWorld();
+								UWorld* World = Fixture.GetWorld();
 								TEST_NOT_NULL_THROW(World);
-								UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 								TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
-								auto ActorClass = ::LoadClass<AActor>(nullptr, TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+								auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
 								TEST_NOT_NULL_THROW(ActorClass);
 								auto Actor = World->SpawnActor<AActor>(ActorClass);
 								TEST_NOT_NULL_THROW(Actor);
@@ -388,6 +321,7 @@ void FComponentSweepSpec::Define()
 								TArray<FHitResult> OutHits;
 								FComponentQueryParams Params;
 								Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+								Fixture.BeginSweeps();
 								bool HitFound = World->ComponentSweepMulti(OutHits, FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 								TEST_TRUE_THROW(HitFound);
 								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, ObstacleMaxZ, 0.1f);
@@ -403,12 +337,12 @@ void FComponentSweepSpec::Define()
 								const FVector SweepEnd = FVector{ 0, 0, 1000.f };
 								const float ObstacleMinZ = -150.f;
 
-								UWorld* World = CreateWorld();
+								UWorld* World = Fixture.GetWorld();
 								TEST_NOT_NULL_THROW(World);
-								UBoxComponent* FloorPlaneCollider = CreateFloor(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
 								TEST_NOT_NULL_THROW(FloorPlaneCollider);
 
-								auto ActorClass = ::LoadClass<AActor>(nullptr, TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+								auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
 								TEST_NOT_NULL_THROW(ActorClass);
 								auto Actor = World->SpawnActor<AActor>(ActorClass);
 								TEST_NOT_NULL_THROW(Actor);
@@ -424,6 +358,7 @@ void FComponentSweepSpec::Define()
 								TArray<FHitResult> OutHits;
 								FComponentQueryParams Params;
 								Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+								Fixture.BeginSweeps();
 								bool HitFound = World->ComponentSweepMulti(OutHits, FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
 								TEST_TRUE_THROW(HitFound);
 								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, ObstacleMinZ, 0.1f);
@@ -431,16 +366,48 @@ void FComponentSweepSpec::Define()
 							}
 							catch (...) {}
 						});
+
+					It("Floor hits UBoxCollider pair from above (batch-welded)", [this]()
+						{
+							try {
+								const FVector SweepStart = FVector{ 0, 0, 1000.f };
+								const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+								const float ObstacleMaxZ = 100.f;
+
+								UWorld* World = Fixture.GetWorld();
+								TEST_NOT_NULL_THROW(World);
+								UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+								TEST_NOT_NULL_THROW(FloorPlaneCollider);
+
+								auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+								TEST_NOT_NULL_THROW(ActorClass);
+								auto Actor = World->SpawnActor<AActor>(ActorClass);
+								TEST_NOT_NULL_THROW(Actor);
+								TArray<UBoxComponent*> Boxes;
+								Actor->GetComponents(Boxes);
+								TEST_EQUAL_THROW(Boxes.Num(), 2);
+								auto Box1 = Boxes[0];
+								TEST_NOT_NULL_THROW(Box1);
+								auto Box2 = Boxes[1];
+								TEST_NOT_NULL_THROW(Box2);
+								TArray<UPrimitiveComponent*> Children{ Box2 };
+								TEST_EQUAL_THROW(FComponentWeldBatch::WeldTo(Box1, Children), 1);
+								TEST_TRUE_THROW(Box2->IsWelded());
+
+								TArray<FHitResult> OutHits;
+								FComponentQueryParams Params;
+								Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+								Fixture.BeginSweeps();
+								bool HitFound = World->ComponentSweepMulti(OutHits, FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+								TEST_TRUE_THROW(HitFound);
+								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].ImpactPoint.Z, ObstacleMaxZ, 0.1f);
+								TEST_EQUAL_TOLERANCE_THROW(OutHits[0].Distance, SweepStart.Z - FloorPlaneCollider->GetScaledBoxExtent().Z - ObstacleMaxZ, 0.1f);
+							}
+							catch (...) {}
+						});
 				});
 		});
 
 	AfterEach([this]() {
 		});
 }
- 
-
-#undef TEST_TRUE_THROW
-#undef TEST_FALSE_THROW
-#undef TEST_NOT_NULL_THROW
-#undef TEST_EQUAL_THROW
-#undef TEST_EQUAL_TOLERANCE_THROW
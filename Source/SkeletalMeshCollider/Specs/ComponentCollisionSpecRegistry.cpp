@@ -0,0 +1,42 @@
+#include "ComponentCollisionSpecRegistry.h"
+
+#include "Engine/Engine.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "SkeletalMeshCollider.h"
+
+void FComponentCollisionSpecRegistry::UnregisterAll()
+{
+	for (const TCHAR* SpecClassName : GetSpecClassNames())
+		FAutomationTestFramework::Get().UnregisterAutomationTest(SpecClassName);
+}
+
+void FComponentCollisionSpecRegistry::RunShardFromCommandLine()
+{
+	FString ShardFile;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ComponentCollisionShard="), ShardFile))
+		return;
+
+	// The test paths contain commas, which -ExecCmds would split on, so the command is queued from here instead
+	FCoreDelegates::OnFEngineLoopInitComplete.AddLambda([ShardFile]()
+		{
+			TArray<FString> TestPaths;
+			FFileHelper::LoadFileToStringArray(TestPaths, *ShardFile);
+			TestPaths.RemoveAll([](const FString& TestPath) { return TestPath.TrimStartAndEnd().IsEmpty(); });
+			if (!GEngine || TestPaths.Num() == 0)
+			{
+				UE_LOG(LogSkeletalMeshCollider, Error, TEXT("No tests to run in shard file %s"), *ShardFile);
+				FPlatformMisc::RequestExitWithStatus(false, 1);
+				return;
+			}
+
+			GEngine->DeferredCommands.Add(FString::Printf(TEXT("Automation RunTests %s;Quit"), *FString::Join(TestPaths, TEXT("+"))));
+		});
+}
+
+TArray<const TCHAR*>& FComponentCollisionSpecRegistry::GetSpecClassNames()
+{
+	static TArray<const TCHAR*> SpecClassNames;
+	return SpecClassNames;
+}
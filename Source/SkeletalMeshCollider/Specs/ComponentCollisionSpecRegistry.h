@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+/**
+ * Keeps track of the ComponentCollision spec classes, so the module can unregister them on shutdown (workaround
+ * for UE-25350) without a hand-maintained list, and runs the tests of a shard when the editor is started with
+ * -ComponentCollisionShard=<file>, a file listing one full test path per line.
+ *
+ * Specs register themselves by ending their definition with END_DEFINE_COMPONENT_COLLISION_SPEC instead of
+ * END_DEFINE_SPEC.
+ */
+class FComponentCollisionSpecRegistry
+{
+public:
+	struct FAutoRegister
+	{
+		explicit FAutoRegister(const TCHAR* SpecClassName) { GetSpecClassNames().Add(SpecClassName); }
+	};
+
+	static void UnregisterAll();
+
+	/** Queues "Automation RunTests" for the tests of the shard file given on the command line, followed by Quit. */
+	static void RunShardFromCommandLine();
+
+private:
+	static TArray<const TCHAR*>& GetSpecClassNames();
+};
+
+#define END_DEFINE_COMPONENT_COLLISION_SPEC(TClass) \
+	END_DEFINE_SPEC(TClass) \
+	namespace { FComponentCollisionSpecRegistry::FAutoRegister TClass##SpecRegistration(TEXT(#TClass)); }
@@ -0,0 +1,92 @@
+#include "ComponentCollisionTestFixture.h"
+
+#include "ComponentCollisionTestHelpers.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformTime.h"
+
+void FComponentCollisionTestFixture::BeginTest(const FString& Scope)
+{
+	TestSetupSeconds = 0.0;
+	TestSweepSeconds = 0.0;
+	SwitchPhase(&TestSetupSeconds);
+
+	if (!World.IsValid() || !Floor.IsValid() || Scope != CurrentScope)
+	{
+		CurrentScope = Scope;
+		CreatePooledWorld();
+	}
+	else
+		ResetPooledWorld();
+}
+
+void FComponentCollisionTestFixture::BeginSweeps()
+{
+	SwitchPhase(&TestSweepSeconds);
+}
+
+void FComponentCollisionTestFixture::EndTest(FAutomationTestBase& Test)
+{
+	SwitchPhase(nullptr);
+	TotalSetupSeconds += TestSetupSeconds;
+	TotalSweepSeconds += TestSweepSeconds;
+
+	Test.AddInfo(FString::Printf(TEXT("Setup %.2f ms, sweeps %.2f ms (suite so far: setup %.2f ms, sweeps %.2f ms)"),
+		TestSetupSeconds * 1000.0, TestSweepSeconds * 1000.0, TotalSetupSeconds * 1000.0, TotalSweepSeconds * 1000.0));
+}
+
+float FComponentCollisionTestFixture::GetFloorTopZ() const
+{
+	return Floor->GetComponentLocation().Z + Floor->GetScaledBoxExtent().Z;
+}
+
+float FComponentCollisionTestFixture::ExpectedFloorHitDistance(const FRefPoseCubeVariant& Variant, const FVector& SweepStart, float Scale) const
+{
+	return SweepStart.Z - GetFloorTopZ() - Variant.GetCubeHalfZExtent() * Scale;
+}
+
+USkeletalMeshComponent* FComponentCollisionTestFixture::SpawnRefPoseCube(const FRefPoseCubeVariant& Variant, const FVector& Location)
+{
+	UClass* ActorClass = LoadActorClass<ASkeletalMeshActor>(Variant.BlueprintClassPath);
+	ASkeletalMeshActor* Actor = (World.IsValid() && ActorClass) ? World->SpawnActor<ASkeletalMeshActor>(ActorClass, Location, FRotator::ZeroRotator) : nullptr;
+	return Actor ? Actor->GetSkeletalMeshComponent() : nullptr;
+}
+
+UClass* FComponentCollisionTestFixture::LoadClassMemoized(const TCHAR* BlueprintClassPath)
+{
+	static TMap<FString, TWeakObjectPtr<UClass>> LoadedClasses;
+
+	TWeakObjectPtr<UClass>& LoadedClass = LoadedClasses.FindOrAdd(BlueprintClassPath);
+	if (!LoadedClass.IsValid())
+		LoadedClass = ::LoadClass<UObject>(nullptr, BlueprintClassPath);
+	return LoadedClass.Get();
+}
+
+void FComponentCollisionTestFixture::CreatePooledWorld()
+{
+	World = CreateWorld();
+	Floor = CreateFloor(World.Get());
+
+	PersistentActors.Reset();
+	for (TActorIterator<AActor> It(World.Get()); It; ++It)
+		PersistentActors.Add(*It);
+}
+
+void FComponentCollisionTestFixture::ResetPooledWorld()
+{
+	TArray<AActor*> SpawnedActors;
+	for (TActorIterator<AActor> It(World.Get()); It; ++It)
+		if (!PersistentActors.Contains(*It))
+			SpawnedActors.Add(*It);
+
+	for (AActor* Actor : SpawnedActors)
+		World->DestroyActor(Actor);
+}
+
+void FComponentCollisionTestFixture::SwitchPhase(double* NextPhaseSeconds)
+{
+	const double NowSeconds = FPlatformTime::Seconds();
+	if (CurrentPhaseSeconds)
+		*CurrentPhaseSeconds += NowSeconds - CurrentPhaseStartSeconds;
+	CurrentPhaseSeconds = NextPhaseSeconds;
+	CurrentPhaseStartSeconds = NowSeconds;
+}
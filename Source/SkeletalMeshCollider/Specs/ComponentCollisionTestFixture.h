@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Components/BoxComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/WeakObjectPtr.h"
+
+class USkeletalMeshComponent;
+struct FRefPoseCubeVariant;
+
+/**
+ * Shared world for a group of ComponentCollision tests.
+ *
+ * The first test in a scope creates a new map and its floor; every following test in the same scope reuses
+ * that world, after the actors spawned by the previous test have been destroyed. Actor classes are loaded
+ * once and memoized for the lifetime of the process.
+ *
+ * The fixture also splits the wall-clock time of each test into setup (world creation, reset, spawning) and
+ * sweeps, so the suite can report where its time goes.
+ */
+class FComponentCollisionTestFixture
+{
+public:
+	/** Prepares the world for a test in Scope, creating a new one if the previous test ran in another scope. */
+	void BeginTest(const FString& Scope);
+
+	/** Marks the end of setup; the time until EndTest is accounted as sweep time. */
+	void BeginSweeps();
+
+	/** Stops timing the current test and reports its setup and sweep times on Test. */
+	void EndTest(FAutomationTestBase& Test);
+
+	UWorld* GetWorld() const { return World.Get(); }
+	UBoxComponent* GetFloor() const { return Floor.Get(); }
+
+	/** The Z of the top face of the floor. */
+	float GetFloorTopZ() const;
+
+	/** The Distance of the floor hit of a Variant cube, at Scale, swept straight down from SweepStart. */
+	float ExpectedFloorHitDistance(const FRefPoseCubeVariant& Variant, const FVector& SweepStart, float Scale = 1.f) const;
+
+	/** Spawns the blueprint of Variant at Location and returns its skeletal mesh component, or null if it couldn't be spawned. */
+	USkeletalMeshComponent* SpawnRefPoseCube(const FRefPoseCubeVariant& Variant, const FVector& Location = FVector::ZeroVector);
+
+	template <class ActorType>
+	UClass* LoadActorClass(const TCHAR* BlueprintClassPath)
+	{
+		UClass* ActorClass = LoadClassMemoized(BlueprintClassPath);
+		return (ActorClass && ActorClass->IsChildOf(ActorType::StaticClass())) ? ActorClass : nullptr;
+	}
+
+private:
+	static UClass* LoadClassMemoized(const TCHAR* BlueprintClassPath);
+
+	void CreatePooledWorld();
+	void ResetPooledWorld();
+	void SwitchPhase(double* NextPhaseSeconds);
+
+	FString CurrentScope;
+	TWeakObjectPtr<UWorld> World;
+	TWeakObjectPtr<UBoxComponent> Floor;
+	TArray<TWeakObjectPtr<AActor>> PersistentActors;
+
+	double* CurrentPhaseSeconds = nullptr;
+	double CurrentPhaseStartSeconds = 0.0;
+	double TestSetupSeconds = 0.0;
+	double TestSweepSeconds = 0.0;
+	double TotalSetupSeconds = 0.0;
+	double TotalSweepSeconds = 0.0;
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "Animation/SkeletalMeshActor.h"
+#include "AnimationRuntime.h"
+#include "AutomationEditorCommon.h"
+#include "Components/BoxComponent.h"
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#define TEST_TRUE_THROW(expression) \
+	do { if (!(expression)) { AddError(TEXT("Expected '") TEXT(#expression) TEXT("' to be true."), 0); throw 0; } } while (0)
+
+#define TEST_FALSE_THROW(expression) \
+	do { if ((expression)) { AddError(TEXT("Expected '") TEXT(#expression) TEXT("' to be false."), 0); throw 0; } } while (0)
+
+#define TEST_NOT_NULL_THROW(expression) \
+	do { if (!(expression)) { AddError(TEXT("Expected '") TEXT(#expression) TEXT("' to be not null."), 0); throw 0; } } while (0)
+
+#define TEST_EQUAL_THROW(expression, expected) \
+	do { if ((expression) != (expected)) { AddError(FString::Printf(TEXT("%s%d"), TEXT("Expected ") TEXT(#expression) TEXT(" to be equal to ") TEXT(#expected) TEXT(", but it was "), (expression)), 0); throw 0; } } while (0)
+
+template <typename T>
+FString ToString(const T& object);
+
+template <>
+inline FString ToString(const FVector& object)
+{
+	return object.ToString();
+}
+
+template <>
+inline FString ToString(const int& value)
+{
+	return FString::Printf(TEXT("%d"), value);
+}
+
+template <>
+inline FString ToString(const float& value)
+{
+	return FString::Printf(TEXT("%f"), value);
+}
+
+
+template <typename T>
+bool TestEqualWithToleranceComparison(const T& a, const T& b, float Tolerance);
+
+template <>
+inline bool TestEqualWithToleranceComparison(const FVector& a, const FVector& b, const float Tolerance)
+{
+	return a.Equals(b, Tolerance);
+}
+
+template <>
+inline bool TestEqualWithToleranceComparison(const int& a, const int& b, const float Tolerance)
+{
+	return FMath::IsNearlyEqual(a, b, Tolerance);
+}
+
+template <>
+inline bool TestEqualWithToleranceComparison(const float& a, const float& b, const float Tolerance)
+{
+	return FMath::IsNearlyEqual(a, b, Tolerance);
+}
+
+#define TEST_EQUAL_TOLERANCE_THROW(expression, expected, tolerance) \
+	do { if (!TestEqualWithToleranceComparison((expression), (expected), (tolerance))) { AddError(FString::Printf(TEXT("Expected ") TEXT(#expression) TEXT(" to be equal to %s but it was %s"), *ToString(expected), *ToString(expression)), 0); throw 0; } } while (0)
+
+inline UWorld* CreateWorld()
+{
+	auto World = FAutomationEditorCommonUtils::CreateNewMap();
+	check(World);
+	return World;
+}
+
+inline UBoxComponent* CreateFloor(UWorld* World)
+{
+	auto FloorPlane = World->SpawnActor<AActor>();
+	check(FloorPlane);
+	auto FloorPlaneCollider = NewObject<UBoxComponent>(FloorPlane, UBoxComponent::StaticClass(), TEXT("FloorPlaneCollider"));
+	check(FloorPlaneCollider);
+	FloorPlaneCollider->RegisterComponent();
+	FloorPlaneCollider->SetWorldLocation(FVector{ 0, 0, -281.f });
+	FloorPlaneCollider->SetBoxExtent(FVector{ 1000, 1000, 1.f });
+	FloorPlaneCollider->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	FloorPlaneCollider->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+
+	return FloorPlaneCollider;
+}
+
+template <class ComponentType>
+ComponentType* CreatePrimitiveCollider(UWorld* World)
+{
+	auto Actor = World->SpawnActor<AActor>();
+	check(Actor);
+	auto Component = NewObject<ComponentType>(Actor, ComponentType::StaticClass(), TEXT("Collider"));
+	check(Component);
+	Component->RegisterComponent();
+	Component->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	Component->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+
+	return Component;
+}
+
+struct FSweepBenchmarkStats
+{
+	int32 NumSweeps = 0;
+	double MinNs = 0.0;
+	double MedianNs = 0.0;
+	double P99Ns = 0.0;
+};
+
+/** Min, median and p99 of SamplesNs, which it sorts. */
+inline FSweepBenchmarkStats ComputeSweepBenchmarkStats(TArray<double>& SamplesNs)
+{
+	FSweepBenchmarkStats Stats;
+	if (SamplesNs.Num() == 0)
+		return Stats;
+
+	SamplesNs.Sort();
+	Stats.NumSweeps = SamplesNs.Num();
+	Stats.MinNs = SamplesNs[0];
+	Stats.MedianNs = SamplesNs[SamplesNs.Num() / 2];
+	Stats.P99Ns = SamplesNs[FMath::Clamp(FMath::CeilToInt(SamplesNs.Num() * 0.99f) - 1, 0, SamplesNs.Num() - 1)];
+	return Stats;
+}
+
+/**
+ * Half extents of the collider of the ref pose cubes by variant name, generated from their FBX sources by
+ * Tools/GenerateRefPoseCubeExtents.py. Every expected distance of the specs depends on them, so a missing or
+ * malformed file is fatal rather than a source of zero extents.
+ */
+inline const TMap<FString, FVector>& GetRefPoseCubeHalfExtents()
+{
+	static const TMap<FString, FVector> HalfExtents = []()
+	{
+		const FString Path = FPaths::ProjectContentDir() / TEXT("ComponentCollision/RefPoseCubeExtents.json");
+		FString JsonText;
+		TSharedPtr<FJsonObject> JsonObject;
+		checkf(FFileHelper::LoadFileToString(JsonText, *Path), TEXT("Missing %s; run Tools/GenerateRefPoseCubeExtents.py"), *Path);
+		checkf(FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonText), JsonObject) && JsonObject.IsValid(), TEXT("%s is not valid JSON; run Tools/GenerateRefPoseCubeExtents.py"), *Path);
+
+		TMap<FString, FVector> Result;
+		for (const auto& Variant : JsonObject->Values)
+		{
+			const TSharedPtr<FJsonObject>* VariantObject;
+			const TArray<TSharedPtr<FJsonValue>>* HalfExtent;
+			checkf(Variant.Value->TryGetObject(VariantObject) && (*VariantObject)->TryGetArrayField(TEXT("HalfExtent"), HalfExtent) && HalfExtent->Num() == 3,
+				TEXT("%s has no HalfExtent for %s; run Tools/GenerateRefPoseCubeExtents.py"), *Path, *Variant.Key);
+			Result.Add(Variant.Key, FVector{ (float)(*HalfExtent)[0]->AsNumber(), (float)(*HalfExtent)[1]->AsNumber(), (float)(*HalfExtent)[2]->AsNumber() });
+		}
+		return Result;
+	}();
+	return HalfExtents;
+}
+
+/** The skeletal mesh cube blueprints under Content/ComponentCollision. */
+struct FRefPoseCubeVariant
+{
+	const TCHAR* Name;
+	const TCHAR* BlueprintClassPath;
+
+	/** The Z half extent of the collider of the cube. */
+	float GetCubeHalfZExtent() const
+	{
+		const FVector* HalfExtent = GetRefPoseCubeHalfExtents().Find(Name);
+		checkf(HalfExtent, TEXT("No generated extents for %s; run Tools/GenerateRefPoseCubeExtents.py"), Name);
+		return HalfExtent->Z;
+	}
+};
+
+static const FRefPoseCubeVariant RefPoseCubeVariants[] = {
+	{ TEXT("Cube-IdentityRefPose"), TEXT("Blueprint'/Game/ComponentCollision/Cube-IdentityRefPose/BP_Cube-IdentityRefPose.BP_Cube-IdentityRefPose_C'") },
+	{ TEXT("Cube-RotatedRefPose"), TEXT("Blueprint'/Game/ComponentCollision/Cube-RotatedRefPose/BP_Cube-RotatedRefPose.BP_Cube-RotatedRefPose_C'") },
+	{ TEXT("Cube-ScaledRefPose"), TEXT("Blueprint'/Game/ComponentCollision/Cube-ScaledRefPose/BP_Cube-ScaledRefPose.BP_Cube-ScaledRefPose_C'") },
+	{ TEXT("Cube-ScaledAndRotatedRefPose"), TEXT("Blueprint'/Game/ComponentCollision/Cube-ScaledAndRotatedRefPose/BP_Cube-ScaledAndRotatedRefPose.BP_Cube-ScaledAndRotatedRefPose_C'") },
+};
+
+/** Spawns NumActors actors of ActorClass on a square grid centered on the origin, and returns their skeletal mesh components. */
+inline TArray<USkeletalMeshComponent*> SpawnSkeletalMeshActorGrid(UWorld* World, UClass* ActorClass, int32 NumActors, float Spacing)
+{
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumActors)));
+	TArray<USkeletalMeshComponent*> Components;
+	Components.Reserve(NumActors);
+	for (int32 Index = 0; Index < NumActors; Index++)
+	{
+		const FVector Location{ (Index % GridSize - (GridSize - 1) * 0.5f) * Spacing, (Index / GridSize - (GridSize - 1) * 0.5f) * Spacing, 0.f };
+		auto Actor = World->SpawnActor<ASkeletalMeshActor>(ActorClass, Location, FRotator::ZeroRotator);
+		check(Actor);
+		Components.Add(Actor->GetSkeletalMeshComponent());
+	}
+
+	return Components;
+}
+
+/**
+ * Moves the bone of the first physics body of Component to its ref pose plus Offset in component space, the way an
+ * animation moving part of the skeleton would; the physics state is left alone.
+ */
+inline bool SetBodyBoneOffset(USkeletalMeshComponent* Component, const FVector& Offset)
+{
+	const UPhysicsAsset* PhysicsAsset = Component->GetPhysicsAsset();
+	if (!Component->SkeletalMesh || !PhysicsAsset || PhysicsAsset->SkeletalBodySetups.Num() == 0 || !PhysicsAsset->SkeletalBodySetups[0])
+		return false;
+
+	const int32 BoneIndex = Component->GetBoneIndex(PhysicsAsset->SkeletalBodySetups[0]->BoneName);
+	const TArray<FTransform> ComponentSpaceTransforms = Component->GetComponentSpaceTransforms();
+	if (!ComponentSpaceTransforms.IsValidIndex(BoneIndex))
+		return false;
+
+	// With double buffering the editable transforms are last frame's, so the current pose is copied over first
+	TArray<FTransform>& EditableTransforms = Component->GetEditableComponentSpaceTransforms();
+	EditableTransforms = ComponentSpaceTransforms;
+	FTransform BoneTransform = FAnimationRuntime::GetComponentSpaceTransformRefPose(Component->SkeletalMesh->RefSkeleton, BoneIndex);
+	BoneTransform.AddToTranslation(Offset);
+	EditableTransforms[BoneIndex] = BoneTransform;
+	Component->ApplyEditedComponentSpaceTransforms();
+	return true;
+}
@@ -0,0 +1,109 @@
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "ComponentSweepBatch.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+BEGIN_DEFINE_SPEC(FComponentSweepBatchSpec, "ComponentCollision.Batch", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FComponentSweepBatchSpec)
+
+void FComponentSweepBatchSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("Batch")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("FComponentSweepBatch::ComponentSweepMulti", [this]()
+		{
+			It("matches UWorld::ComponentSweepMulti for every ref pose cube variant", [this]()
+				{
+					try {
+						const float CubeSpacing = 500.f;
+						const int32 NumCubesPerVariant = 3;
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						TEST_NOT_NULL_THROW(Fixture.GetFloor());
+
+						TArray<FComponentSweepRequest> Requests;
+						TArray<const FRefPoseCubeVariant*> RequestVariants;
+						for (int32 VariantIndex = 0; VariantIndex < UE_ARRAY_COUNT(RefPoseCubeVariants); VariantIndex++)
+						{
+							const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[VariantIndex];
+							for (int32 CubeIndex = 0; CubeIndex < NumCubesPerVariant; CubeIndex++)
+							{
+								const FVector Location = FVector{ (VariantIndex - 1.5f) * CubeSpacing, (CubeIndex - (NumCubesPerVariant - 1) * 0.5f) * CubeSpacing, 0.f };
+								USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant, Location);
+								TEST_NOT_NULL_THROW(Component);
+
+								FComponentSweepRequest& Request = Requests.AddDefaulted_GetRef();
+								Request.Component = Component;
+								Request.Start = Location + FVector{ 0, 0, 1000.f };
+								Request.End = Location + FVector{ 0, 0, -1000.f };
+								Request.Params.AddIgnoredActor(Component->GetOwner());
+								RequestVariants.Add(&Variant);
+							}
+						}
+
+						Fixture.BeginSweeps();
+						FComponentSweepBatchResults Results;
+						FComponentSweepBatch::ComponentSweepMulti(World, Requests, Results);
+						TEST_EQUAL_THROW(Results.NumHits.Num(), Requests.Num());
+
+						for (int32 RequestIndex = 0; RequestIndex < Requests.Num(); RequestIndex++)
+						{
+							const FComponentSweepRequest& Request = Requests[RequestIndex];
+							TArray<FHitResult> OutHits;
+							const bool HitFound = World->ComponentSweepMulti(OutHits, Request.Component, Request.Start, Request.End, Request.Rotation, Request.Params);
+
+							const TArrayView<const FHitResult> BatchHits = Results.GetHits(RequestIndex);
+							TEST_TRUE_THROW(HitFound);
+							TEST_TRUE_THROW(Results.BlockingHitFound[RequestIndex]);
+							TEST_FALSE_THROW(Results.Truncated[RequestIndex]);
+							TEST_EQUAL_THROW(BatchHits.Num(), OutHits.Num());
+							for (int32 HitIndex = 0; HitIndex < OutHits.Num(); HitIndex++)
+							{
+								TEST_TRUE_THROW(BatchHits[HitIndex].Component == OutHits[HitIndex].Component);
+								TEST_EQUAL_TOLERANCE_THROW(BatchHits[HitIndex].ImpactPoint, OutHits[HitIndex].ImpactPoint, 0.01f);
+								TEST_EQUAL_TOLERANCE_THROW(BatchHits[HitIndex].Distance, OutHits[HitIndex].Distance, 0.01f);
+							}
+
+							TEST_EQUAL_TOLERANCE_THROW(BatchHits.Last().ImpactPoint.Z, Fixture.GetFloorTopZ(), 0.1f);
+							TEST_EQUAL_TOLERANCE_THROW(BatchHits.Last().Distance, Fixture.ExpectedFloorHitDistance(*RequestVariants[RequestIndex], Request.Start), 0.1f);
+						}
+					}
+					catch (...) {}
+				});
+
+			It("reuses the hit buffer between batches", [this]()
+				{
+					try {
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+
+						FComponentSweepRequest Request;
+						Request.Component = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[0]);
+						TEST_NOT_NULL_THROW(Request.Component);
+						Request.Start = FVector{ 0, 0, 1000.f };
+						Request.End = FVector{ 0, 0, -1000.f };
+						Request.Params.AddIgnoredActor(Request.Component->GetOwner());
+						TArray<FComponentSweepRequest> Requests;
+						Requests.Init(Request, 64);
+
+						Fixture.BeginSweeps();
+						FComponentSweepBatchResults Results;
+						FComponentSweepBatch::ComponentSweepMulti(World, Requests, Results);
+						const FHitResult* HitBuffer = Results.Hits.GetData();
+						FComponentSweepBatch::ComponentSweepMulti(World, Requests, Results);
+						TEST_TRUE_THROW(Results.Hits.GetData() == HitBuffer);
+						for (int32 RequestIndex = 0; RequestIndex < Requests.Num(); RequestIndex++)
+							TEST_TRUE_THROW(Results.BlockingHitFound[RequestIndex]);
+					}
+					catch (...) {}
+				});
+		});
+}
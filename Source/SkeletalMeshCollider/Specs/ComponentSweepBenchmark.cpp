@@ -0,0 +1,107 @@
+#include "ComponentSweepBenchmark.h"
+
+#include "Dom/JsonObject.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+	/** Shards running in parallel each get their own report, given with -SweepBenchmarkReport=, and merge them afterwards. */
+	FString GetSweepBenchmarkReportPath()
+	{
+		FString ReportPath;
+		if (FParse::Value(FCommandLine::Get(), TEXT("SweepBenchmarkReport="), ReportPath))
+			return ReportPath;
+		return FPaths::ProjectSavedDir() / TEXT("Automation/Benchmarks/ComponentSweep.json");
+	}
+
+	FString GetSweepBenchmarkBaselinePath()
+	{
+		return FPaths::ProjectDir() / TEXT("Benchmarks/ComponentSweepBaseline.json");
+	}
+
+	TSharedPtr<FJsonObject> LoadJsonFile(const FString& Path)
+	{
+		FString JsonText;
+		TSharedPtr<FJsonObject> JsonObject;
+		if (FFileHelper::LoadFileToString(JsonText, *Path))
+			FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonText), JsonObject);
+		return JsonObject;
+	}
+
+	bool SaveJsonFile(const FString& Path, const TSharedRef<FJsonObject>& JsonObject)
+	{
+		FString JsonText;
+		if (!FJsonSerializer::Serialize(JsonObject, TJsonWriterFactory<>::Create(&JsonText)))
+			return false;
+		return FFileHelper::SaveStringToFile(JsonText, *Path);
+	}
+
+	/** Merges the stats for one variant into the JSON file at Path, keeping the other variants already in it. */
+	bool WriteSweepBenchmarkStats(const FString& Path, const FString& Variant, const FSweepBenchmarkStats& Stats)
+	{
+		TSharedPtr<FJsonObject> Report = LoadJsonFile(Path);
+		if (!Report.IsValid())
+			Report = MakeShared<FJsonObject>();
+
+		const TSharedPtr<FJsonObject>* ExistingVariants = nullptr;
+		TSharedRef<FJsonObject> Variants = Report->TryGetObjectField(TEXT("Variants"), ExistingVariants) ? ExistingVariants->ToSharedRef() : MakeShared<FJsonObject>();
+
+		TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+		Entry->SetNumberField(TEXT("NumSweeps"), Stats.NumSweeps);
+		Entry->SetNumberField(TEXT("MinNs"), Stats.MinNs);
+		Entry->SetNumberField(TEXT("MedianNs"), Stats.MedianNs);
+		Entry->SetNumberField(TEXT("P99Ns"), Stats.P99Ns);
+		Variants->SetObjectField(Variant, Entry);
+		Report->SetObjectField(TEXT("Variants"), Variants);
+
+		return SaveJsonFile(Path, Report.ToSharedRef());
+	}
+}
+
+int32 GetNumBenchmarkSweeps()
+{
+	int32 NumSweeps = 5000;
+	FParse::Value(FCommandLine::Get(), TEXT("SweepBenchmarkSweeps="), NumSweeps);
+	return FMath::Max(NumSweeps, 1);
+}
+
+void RecordSweepBenchmark(FAutomationTestBase& Test, const FString& Variant, const FSweepBenchmarkStats& Stats)
+{
+	Test.AddInfo(FString::Printf(TEXT("%s: %d sweeps, min %.0f ns, median %.0f ns, p99 %.0f ns"), *Variant, Stats.NumSweeps, Stats.MinNs, Stats.MedianNs, Stats.P99Ns));
+
+	if (!WriteSweepBenchmarkStats(GetSweepBenchmarkReportPath(), Variant, Stats))
+		Test.AddWarning(FString::Printf(TEXT("Unable to write benchmark report %s"), *GetSweepBenchmarkReportPath()));
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("UpdateSweepBaseline")))
+	{
+		if (!WriteSweepBenchmarkStats(GetSweepBenchmarkBaselinePath(), Variant, Stats))
+			Test.AddError(FString::Printf(TEXT("Unable to write benchmark baseline %s"), *GetSweepBenchmarkBaselinePath()));
+		return;
+	}
+
+	TSharedPtr<FJsonObject> Baseline = LoadJsonFile(GetSweepBenchmarkBaselinePath());
+	const TSharedPtr<FJsonObject>* BaselineVariants = nullptr;
+	const TSharedPtr<FJsonObject>* BaselineEntry = nullptr;
+	// Baselines are recorded on the reference machine, so until one exists a missing variant only warns; runs there
+	// pass -RequireSweepBaseline so a variant added without a baseline can't silently escape the regression check
+	if (!Baseline.IsValid() || !Baseline->TryGetObjectField(TEXT("Variants"), BaselineVariants) || !(*BaselineVariants)->TryGetObjectField(Variant, BaselineEntry))
+	{
+		const FString Message = FString::Printf(TEXT("No baseline recorded for %s in %s; run with -UpdateSweepBaseline on the reference machine to record one"), *Variant, *GetSweepBenchmarkBaselinePath());
+		if (FParse::Param(FCommandLine::Get(), TEXT("RequireSweepBaseline")))
+			Test.AddError(Message);
+		else
+			Test.AddWarning(Message);
+		return;
+	}
+
+	double MaxRegression = 1.25;
+	Baseline->TryGetNumberField(TEXT("MaxRegression"), MaxRegression);
+	const double BaselineMedianNs = (*BaselineEntry)->GetNumberField(TEXT("MedianNs"));
+	if (Stats.MedianNs > BaselineMedianNs * MaxRegression)
+		Test.AddError(FString::Printf(TEXT("%s regressed: median %.0f ns exceeds baseline %.0f ns by more than %.0f%%"), *Variant, Stats.MedianNs, BaselineMedianNs, (MaxRegression - 1.0) * 100.0));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ComponentCollisionTestHelpers.h"
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+/** Times every call of SweepFunction individually, after a short warmup that is not recorded. */
+template <typename SweepFunctionType>
+FSweepBenchmarkStats RunSweepBenchmark(int32 NumSweeps, SweepFunctionType&& SweepFunction)
+{
+	const int32 NumWarmupSweeps = FMath::Max(NumSweeps / 10, 1);
+	for (int32 Index = 0; Index < NumWarmupSweeps; Index++)
+		SweepFunction();
+
+	const double NsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+	TArray<double> SamplesNs;
+	SamplesNs.Reserve(NumSweeps);
+	for (int32 Index = 0; Index < NumSweeps; Index++)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		SweepFunction();
+		SamplesNs.Add((FPlatformTime::Cycles64() - StartCycles) * NsPerCycle);
+	}
+
+	return ComputeSweepBenchmarkStats(SamplesNs);
+}
+
+/** Sweeps per benchmark, 5000 unless given with -SweepBenchmarkSweeps=. */
+int32 GetNumBenchmarkSweeps();
+
+/**
+ * Reports the stats of Variant on Test, merges them into the benchmark report and checks them against the
+ * committed baseline, or records them as the baseline when the editor runs with -UpdateSweepBaseline.
+ */
+void RecordSweepBenchmark(FAutomationTestBase& Test, const FString& Variant, const FSweepBenchmarkStats& Stats);
@@ -0,0 +1,514 @@
+#include "Animation/SkeletalMeshActor.h"
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "ComponentSweepBenchmark.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "ComponentWeldBatch.h"
+#include "CoreMinimal.h"
+#include "DeferredPhysicsStateSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "SkeletalMeshBodyTreeSubsystem.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+/** Spawns an actor with NumBoxes small UBoxComponents laid out in a grid above the floor; the first box is the root. */
+TArray<UPrimitiveComponent*> CreateBoxColliderGrid(UWorld* World, int32 NumBoxes)
+{
+	auto Actor = World->SpawnActor<AActor>();
+	check(Actor);
+
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumBoxes)));
+	const float Spacing = 1800.f / GridSize;
+	TArray<UPrimitiveComponent*> Boxes;
+	for (int32 Index = 0; Index < NumBoxes; Index++)
+	{
+		auto Box = NewObject<UBoxComponent>(Actor, UBoxComponent::StaticClass(), *FString::Printf(TEXT("Collider%d"), Index));
+		check(Box);
+		Box->RegisterComponent();
+		if (Index == 0)
+			Actor->SetRootComponent(Box);
+		Box->SetBoxExtent(FVector{ 20.f, 20.f, 20.f });
+		Box->SetWorldLocation(FVector{ (Index % GridSize - (GridSize - 1) * 0.5f) * Spacing, (Index / GridSize - (GridSize - 1) * 0.5f) * Spacing, 50.f });
+		Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Box->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+		Boxes.Add(Box);
+	}
+
+	return Boxes;
+}
+
+/**
+ * The sweep, spawn and scaling benchmarks. They take minutes rather than seconds, so they are a performance test,
+ * kept out of the ComponentCollision specs that run on every commit; Tools/RunComponentCollisionShards.py runs
+ * them with --benchmarks.
+ */
+BEGIN_DEFINE_SPEC(FComponentSweepBenchmarkSpec, "ComponentCollision.Benchmarks", EAutomationTestFlags::PerfFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FComponentSweepBenchmarkSpec)
+
+void FComponentSweepBenchmarkSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("Benchmarks")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+	{
+		It(FString::Printf(TEXT("USkeletalMeshComponent (%s) sweeps against UBoxComponent"), Variant.Name), [this, Variant]()
+			{
+				try {
+					const FVector SweepStart = FVector{ 0, 0, 1000.f };
+					const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+					UWorld* World = Fixture.GetWorld();
+					TEST_NOT_NULL_THROW(World);
+					TEST_NOT_NULL_THROW(Fixture.GetFloor());
+					USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+					TEST_NOT_NULL_THROW(Component);
+
+					TArray<FHitResult> OutHits;
+					FComponentQueryParams Params;
+					Params.AddIgnoredActor(Component->GetOwner());
+					Fixture.BeginSweeps();
+					TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+
+					const FSweepBenchmarkStats Stats = RunSweepBenchmark(GetNumBenchmarkSweeps(), [&]()
+						{
+							World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+						});
+					RecordSweepBenchmark(*this, Variant.Name, Stats);
+				}
+				catch (...) {}
+			});
+	}
+
+	It("USkeletalMeshComponent (Cube-ScaledAndRotatedRefPose) sweeps with cached body shapes against UBoxComponent", [this]()
+		{
+			try {
+				const FVector SweepStart = FVector{ 0, 0, 1000.f };
+				const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+				const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+
+				UWorld* World = Fixture.GetWorld();
+				TEST_NOT_NULL_THROW(World);
+				auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+				TEST_NOT_NULL_THROW(Subsystem);
+				USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+				TEST_NOT_NULL_THROW(Component);
+
+				TArray<FHitResult> OutHits;
+				FComponentQueryParams Params;
+				Params.AddIgnoredActor(Component->GetOwner());
+				Fixture.BeginSweeps();
+				TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+
+				const FSweepBenchmarkStats UncachedStats = RunSweepBenchmark(GetNumBenchmarkSweeps(), [&]()
+					{
+						World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+					});
+				const FSweepBenchmarkStats CachedStats = RunSweepBenchmark(GetNumBenchmarkSweeps(), [&]()
+					{
+						Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+					});
+				AddInfo(FString::Printf(TEXT("Cached body shapes: median %.0f ns vs %.0f ns uncached (%.2fx)"), CachedStats.MedianNs, UncachedStats.MedianNs, UncachedStats.MedianNs / FMath::Max(CachedStats.MedianNs, 1.0)));
+				RecordSweepBenchmark(*this, FString(Variant.Name) + TEXT("-CachedBodyShapes"), CachedStats);
+			}
+			catch (...) {}
+		});
+
+	It("USkeletalMeshComponent (Cube-ScaledAndRotatedRefPose) sweeps with a moving body bone against UBoxComponent", [this]()
+		{
+			try {
+				const FVector SweepStart = FVector{ 0, 0, 1000.f };
+				const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+				const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+				const int32 NumSweepsPerFrame = 4;
+				const int32 NumFrames = FMath::DivideAndRoundUp(GetNumBenchmarkSweeps(), NumSweepsPerFrame);
+
+				UWorld* World = Fixture.GetWorld();
+				TEST_NOT_NULL_THROW(World);
+				auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+				TEST_NOT_NULL_THROW(Subsystem);
+				USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+				TEST_NOT_NULL_THROW(Component);
+
+				TArray<FHitResult> OutHits;
+				FComponentQueryParams Params;
+				Params.AddIgnoredActor(Component->GetOwner());
+				Fixture.BeginSweeps();
+				TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+
+				// Every frame the bone carrying the body moves, untimed, and is then swept several times
+				const double NsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+				auto RunAnimatedSweepBenchmark = [&](auto&& SweepFunction)
+				{
+					TArray<double> SamplesNs;
+					SamplesNs.Reserve(NumFrames * NumSweepsPerFrame);
+					for (int32 Frame = 0; Frame < NumFrames; Frame++)
+					{
+						SetBodyBoneOffset(Component, FVector{ 0, 0, 10.f + 10.f * FMath::Sin(Frame * 0.1f) });
+						for (int32 Index = 0; Index < NumSweepsPerFrame; Index++)
+						{
+							const uint64 StartCycles = FPlatformTime::Cycles64();
+							SweepFunction();
+							SamplesNs.Add((FPlatformTime::Cycles64() - StartCycles) * NsPerCycle);
+						}
+					}
+					return ComputeSweepBenchmarkStats(SamplesNs);
+				};
+
+				// Both sides sweep through the subsystem, so they see the same animated pose; without the cache every
+				// query rebuilds the body shapes from the pose
+				const int32 NumRebuildsBeforeUncached = Subsystem->GetBodyShapes(*Component).GetNumRebuilds();
+				const FSweepBenchmarkStats UncachedStats = RunAnimatedSweepBenchmark([&]()
+					{
+						Subsystem->InvalidateBodyShapes(*Component);
+						Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+					});
+				TEST_EQUAL_THROW(Subsystem->GetBodyShapes(*Component).GetNumRebuilds() - NumRebuildsBeforeUncached, NumFrames * NumSweepsPerFrame);
+
+				const int32 NumRebuildsBeforeCached = Subsystem->GetBodyShapes(*Component).GetNumRebuilds();
+				const int32 NumBodyUpdatesBefore = Subsystem->GetBodyShapes(*Component).GetNumBodyUpdates();
+				const FSweepBenchmarkStats CachedStats = RunAnimatedSweepBenchmark([&]()
+					{
+						Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+					});
+				TEST_EQUAL_THROW(Subsystem->GetBodyShapes(*Component).GetNumRebuilds(), NumRebuildsBeforeCached);
+				TEST_EQUAL_THROW(Subsystem->GetBodyShapes(*Component).GetNumBodyUpdates() - NumBodyUpdatesBefore, NumFrames);
+
+				AddInfo(FString::Printf(TEXT("Animated body shapes, %d sweeps per frame: median %.0f ns vs %.0f ns uncached (%.2fx)"), NumSweepsPerFrame, CachedStats.MedianNs, UncachedStats.MedianNs, UncachedStats.MedianNs / FMath::Max(CachedStats.MedianNs, 1.0)));
+				RecordSweepBenchmark(*this, FString(Variant.Name) + TEXT("-AnimatedBodyShapes"), CachedStats);
+			}
+			catch (...) {}
+		});
+
+	for (const int32 NumActors : { 1000, 10000 })
+	{
+		It(FString::Printf(TEXT("USkeletalMeshComponent (Cube-ScaledAndRotatedRefPose) sweeps among %d others with the collision LOD proxy"), NumActors), [this, NumActors]()
+			{
+				try {
+					const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+					const float Spacing = 1000.f;
+					const int32 NumSweptComponents = 256;
+
+					UWorld* World = Fixture.GetWorld();
+					TEST_NOT_NULL_THROW(World);
+					auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+					TEST_NOT_NULL_THROW(Subsystem);
+					auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(Variant.BlueprintClassPath);
+					TEST_NOT_NULL_THROW(ActorClass);
+					const TArray<USkeletalMeshComponent*> Components = SpawnSkeletalMeshActorGrid(World, ActorClass, NumActors, Spacing);
+
+					// Randomly picked cubes sweep sideways into their neighbour
+					FRandomStream RandomStream(NumActors);
+					TArray<USkeletalMeshComponent*> SweptComponents;
+					TArray<FComponentQueryParams> SweptParams;
+					for (int32 Index = 0; Index < NumSweptComponents; Index++)
+					{
+						SweptComponents.Add(Components[RandomStream.RandHelper(NumActors)]);
+						SweptParams.AddDefaulted_GetRef().AddIgnoredActor(SweptComponents.Last()->GetOwner());
+					}
+					int32 NextSweep = 0;
+
+					TArray<FHitResult> OutHits;
+					Subsystem->SetCollisionLODOrigin(FVector::ZeroVector);
+					Fixture.BeginSweeps();
+					auto RunLODSweepBenchmark = [&](float ProxyDistance)
+					{
+						return RunSweepBenchmark(GetNumBenchmarkSweeps(), [&]()
+							{
+								const int32 Index = NextSweep++ % NumSweptComponents;
+								const FVector SweepStart = SweptComponents[Index]->GetComponentLocation();
+								Subsystem->ComponentSweepMulti(OutHits, SweptComponents[Index], SweepStart, SweepStart + FVector{ Spacing, 0, 0 }, FQuat(EForceInit::ForceInit), SweptParams[Index], ProxyDistance);
+							});
+					};
+					const FSweepBenchmarkStats FullStats = RunLODSweepBenchmark(MAX_flt);
+					TEST_FALSE_THROW(Subsystem->GetLastSweepStats().bProxy);
+					const FSweepBenchmarkStats ProxyStats = RunLODSweepBenchmark(0.f);
+					TEST_TRUE_THROW(Subsystem->GetLastSweepStats().bProxy);
+					Subsystem->ClearCollisionLODOrigin();
+
+					AddInfo(FString::Printf(TEXT("%d actors: proxy median %.0f ns vs %.0f ns with the physics asset (%.2fx)"), NumActors, ProxyStats.MedianNs, FullStats.MedianNs, FullStats.MedianNs / FMath::Max(ProxyStats.MedianNs, 1.0)));
+					RecordSweepBenchmark(*this, FString::Printf(TEXT("%s-%d-FullCollision"), Variant.Name, NumActors), FullStats);
+					RecordSweepBenchmark(*this, FString::Printf(TEXT("%s-%d-ProxyCollision"), Variant.Name, NumActors), ProxyStats);
+				}
+				catch (...) {}
+			});
+	}
+
+	for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+	{
+		for (const int32 NumSpawns : { 1000, 10000 })
+		{
+			It(FString::Printf(TEXT("Spawn %d %s actors with and without deferred physics state"), NumSpawns, Variant.Name), [this, Variant, NumSpawns]()
+				{
+					try {
+						const float Spacing = 500.f;
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						auto DeferredPhysicsState = World->GetSubsystem<UDeferredPhysicsStateSubsystem>();
+						TEST_NOT_NULL_THROW(DeferredPhysicsState);
+						auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(Variant.BlueprintClassPath);
+						TEST_NOT_NULL_THROW(ActorClass);
+
+						// Every spawn is timed on its own, so the stats show the hitches as well as the throughput
+						const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumSpawns)));
+						const double NsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+						TArray<AActor*> Actors;
+						auto RunSpawnBenchmark = [&](auto&& SpawnFunction, double& OutSeconds)
+						{
+							TArray<double> SamplesNs;
+							SamplesNs.Reserve(NumSpawns);
+							const double StartSeconds = FPlatformTime::Seconds();
+							for (int32 Index = 0; Index < NumSpawns; Index++)
+							{
+								const FTransform Transform(FVector{ (Index % GridSize) * Spacing, (Index / GridSize) * Spacing, 0.f });
+								const uint64 StartCycles = FPlatformTime::Cycles64();
+								Actors.Add(SpawnFunction(Transform));
+								SamplesNs.Add((FPlatformTime::Cycles64() - StartCycles) * NsPerCycle);
+							}
+							OutSeconds = FPlatformTime::Seconds() - StartSeconds;
+							for (AActor* Actor : Actors)
+								Actor->Destroy();
+							Actors.Reset();
+							return ComputeSweepBenchmarkStats(SamplesNs);
+						};
+
+						double ImmediateSeconds = 0.0;
+						const FSweepBenchmarkStats ImmediateStats = RunSpawnBenchmark([&](const FTransform& Transform)
+							{
+								return World->SpawnActor<ASkeletalMeshActor>(ActorClass, Transform);
+							}, ImmediateSeconds);
+						double DeferredSeconds = 0.0;
+						const FSweepBenchmarkStats DeferredStats = RunSpawnBenchmark([&](const FTransform& Transform)
+							{
+								return DeferredPhysicsState->SpawnActor<ASkeletalMeshActor>(ActorClass, Transform);
+							}, DeferredSeconds);
+						DeferredPhysicsState->PrewarmDeferredPhysicsStates(MAX_dbl);
+
+						AddInfo(FString::Printf(TEXT("%s: %d spawns at %.0f/s deferred vs %.0f/s immediate, p99 %.0f ns vs %.0f ns"),
+							Variant.Name, NumSpawns, NumSpawns / FMath::Max(DeferredSeconds, 1e-9), NumSpawns / FMath::Max(ImmediateSeconds, 1e-9), DeferredStats.P99Ns, ImmediateStats.P99Ns));
+						RecordSweepBenchmark(*this, FString::Printf(TEXT("%s-Spawn-%d"), Variant.Name, NumSpawns), ImmediateStats);
+						RecordSweepBenchmark(*this, FString::Printf(TEXT("%s-DeferredSpawn-%d"), Variant.Name, NumSpawns), DeferredStats);
+					}
+					catch (...) {}
+				});
+		}
+	}
+
+	for (const int32 NumActors : { 1000, 10000, 50000 })
+	{
+		It(FString::Printf(TEXT("Sphere sweeps against %d USkeletalMeshComponents (Cube-ScaledAndRotatedRefPose) through the body tree"), NumActors), [this, NumActors]()
+			{
+				try {
+					const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+					const float Spacing = 1000.f;
+					const FCollisionShape SweepShape = FCollisionShape::MakeSphere(50.f);
+					const int32 NumRefits = 10;
+
+					UWorld* World = Fixture.GetWorld();
+					TEST_NOT_NULL_THROW(World);
+					auto Subsystem = World->GetSubsystem<USkeletalMeshBodyTreeSubsystem>();
+					TEST_NOT_NULL_THROW(Subsystem);
+					auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(Variant.BlueprintClassPath);
+					TEST_NOT_NULL_THROW(ActorClass);
+					const TArray<USkeletalMeshComponent*> Components = SpawnSkeletalMeshActorGrid(World, ActorClass, NumActors, Spacing);
+
+					// Straight down onto randomly picked cubes
+					FRandomStream RandomStream(NumActors);
+					TArray<FVector> SweepStarts;
+					for (int32 Index = 0; Index < 1024; Index++)
+						SweepStarts.Add(Components[RandomStream.RandHelper(NumActors)]->GetComponentLocation() + FVector{ 0, 0, 1000.f });
+					int32 NextSweep = 0;
+					auto NextSweepStart = [&]() -> const FVector& { return SweepStarts[NextSweep++ % SweepStarts.Num()]; };
+
+					FHitResult OutHit;
+					TArray<FHitResult> WorldHits;
+					for (const FVector& SweepStart : SweepStarts)
+					{
+						World->SweepSingleByChannel(OutHit, SweepStart, SweepStart - FVector{ 0, 0, 2000.f }, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape);
+						WorldHits.Add(OutHit);
+					}
+
+					Fixture.BeginSweeps();
+					const FSweepBenchmarkStats WorldStats = RunSweepBenchmark(GetNumBenchmarkSweeps(), [&]()
+						{
+							const FVector& SweepStart = NextSweepStart();
+							World->SweepSingleByChannel(OutHit, SweepStart, SweepStart - FVector{ 0, 0, 2000.f }, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape);
+						});
+
+					for (USkeletalMeshComponent* Component : Components)
+						TEST_TRUE_THROW(Subsystem->RegisterComponent(Component));
+					const double BuildStartSeconds = FPlatformTime::Seconds();
+					Subsystem->Refit();
+					const double BuildSeconds = FPlatformTime::Seconds() - BuildStartSeconds;
+					const double RefitStartSeconds = FPlatformTime::Seconds();
+					for (int32 Index = 0; Index < NumRefits; Index++)
+						Subsystem->Refit();
+					const double RefitSeconds = (FPlatformTime::Seconds() - RefitStartSeconds) / NumRefits;
+
+					for (int32 Index = 0; Index < SweepStarts.Num(); Index++)
+					{
+						TEST_EQUAL_THROW(Subsystem->SweepSingleByChannel(OutHit, SweepStarts[Index], SweepStarts[Index] - FVector{ 0, 0, 2000.f }, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape), WorldHits[Index].bBlockingHit);
+						TEST_EQUAL_TOLERANCE_THROW(OutHit.ImpactPoint, WorldHits[Index].ImpactPoint, 0.1f);
+					}
+
+					const FSweepBenchmarkStats TreeStats = RunSweepBenchmark(GetNumBenchmarkSweeps(), [&]()
+						{
+							const FVector& SweepStart = NextSweepStart();
+							Subsystem->SweepSingleByChannel(OutHit, SweepStart, SweepStart - FVector{ 0, 0, 2000.f }, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape);
+						});
+
+					AddInfo(FString::Printf(TEXT("%d actors, %d bodies, %d nodes: build %.2f ms, refit %.2f ms, query median %.0f ns vs %.0f ns through the world"),
+						NumActors, Subsystem->GetTree().GetNumLeaves(), Subsystem->GetTree().GetNumNodes(), BuildSeconds * 1000.0, RefitSeconds * 1000.0, TreeStats.MedianNs, WorldStats.MedianNs));
+					for (USkeletalMeshComponent* Component : Components)
+						Subsystem->UnregisterComponent(Component);
+					RecordSweepBenchmark(*this, FString::Printf(TEXT("BodyTree-%d-World"), NumActors), WorldStats);
+					RecordSweepBenchmark(*this, FString::Printf(TEXT("BodyTree-%d"), NumActors), TreeStats);
+				}
+				catch (...) {}
+			});
+	}
+
+	It("USphereComponent sweeps against UBoxComponent", [this]()
+		{
+			try {
+				const FVector SweepStart = FVector{ 0, 0, 1000.f };
+				const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+				const float SphereRadius = 100.f;
+
+				UWorld* World = Fixture.GetWorld();
+				TEST_NOT_NULL_THROW(World);
+				UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+				TEST_NOT_NULL_THROW(FloorPlaneCollider);
+				USphereComponent* Component = CreatePrimitiveCollider<USphereComponent>(World);
+				TEST_NOT_NULL_THROW(Component);
+				Component->SetSphereRadius(SphereRadius);
+
+				TArray<FHitResult> OutHits;
+				FComponentQueryParams Params;
+				Params.AddIgnoredActor(Component->GetOwner());
+				Fixture.BeginSweeps();
+				TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+
+				const FSweepBenchmarkStats Stats = RunSweepBenchmark(GetNumBenchmarkSweeps(), [&]()
+					{
+						World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+					});
+				RecordSweepBenchmark(*this, TEXT("USphereComponent"), Stats);
+			}
+			catch (...) {}
+		});
+
+	for (const int32 NumBoxes : { 1, 10, 50, 100, 300 })
+	{
+		It(FString::Printf(TEXT("Weld and sweep %d welded vs unwelded UBoxColliders"), NumBoxes), [this, NumBoxes]()
+			{
+				try {
+					const FVector SweepDelta = FVector{ 0, 0, -1000.f };
+					const int32 NumSweeps = FMath::Max(GetNumBenchmarkSweeps() / 5, 1);
+
+					UWorld* World = Fixture.GetWorld();
+					TEST_NOT_NULL_THROW(World);
+					UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+					TEST_NOT_NULL_THROW(FloorPlaneCollider);
+
+					const TArray<UPrimitiveComponent*> Boxes = CreateBoxColliderGrid(World, NumBoxes);
+					UPrimitiveComponent* Root = Boxes[0];
+					const TArrayView<UPrimitiveComponent* const> Children = MakeArrayView(Boxes).Slice(1, Boxes.Num() - 1);
+					const float ExpectedDistance = Root->GetComponentLocation().Z - Root->Bounds.BoxExtent.Z - Fixture.GetFloorTopZ();
+
+					// Moving the unwelded compound sweeps each of its colliders; once welded, the root sweeps the shapes of all of them
+					TArray<FHitResult> OutHits;
+					FComponentQueryParams Params;
+					Params.AddIgnoredActor(Root->GetOwner());
+					auto SweepCompound = [&](TArrayView<UPrimitiveComponent* const> SweptBoxes)
+					{
+						bool bBlockingHit = true;
+						for (UPrimitiveComponent* Box : SweptBoxes)
+						{
+							const FVector Start = Box->GetComponentLocation();
+							bBlockingHit &= World->ComponentSweepMulti(OutHits, Box, Start, Start + SweepDelta, Box->GetComponentQuat(), Params);
+						}
+						return bBlockingHit;
+					};
+
+					Fixture.BeginSweeps();
+					TEST_TRUE_THROW(SweepCompound(Boxes));
+					TEST_TRUE_THROW(OutHits.Last().GetComponent() == FloorPlaneCollider);
+					TEST_EQUAL_TOLERANCE_THROW(OutHits.Last().Distance, ExpectedDistance, 0.1f);
+					const FSweepBenchmarkStats UnweldedStats = RunSweepBenchmark(NumSweeps, [&]()
+						{
+							SweepCompound(Boxes);
+						});
+
+					const double BatchWeldStartSeconds = FPlatformTime::Seconds();
+					TEST_EQUAL_THROW(FComponentWeldBatch::WeldTo(Root, Children), Children.Num());
+					const double BatchWeldSeconds = FPlatformTime::Seconds() - BatchWeldStartSeconds;
+
+					const TArrayView<UPrimitiveComponent* const> WeldedRoot = MakeArrayView(Boxes).Slice(0, 1);
+					TEST_TRUE_THROW(SweepCompound(WeldedRoot));
+					TEST_TRUE_THROW(OutHits.Last().GetComponent() == FloorPlaneCollider);
+					TEST_EQUAL_TOLERANCE_THROW(OutHits.Last().Distance, ExpectedDistance, 0.1f);
+					const FSweepBenchmarkStats WeldedStats = RunSweepBenchmark(NumSweeps, [&]()
+						{
+							SweepCompound(WeldedRoot);
+						});
+
+					// The same compound again, welded one child at a time, each weld updating the root body
+					const TArray<UPrimitiveComponent*> SingleWeldBoxes = CreateBoxColliderGrid(World, NumBoxes);
+					const double SingleWeldStartSeconds = FPlatformTime::Seconds();
+					for (int32 Index = 1; Index < SingleWeldBoxes.Num(); Index++)
+						SingleWeldBoxes[Index]->WeldTo(SingleWeldBoxes[0]);
+					const double SingleWeldSeconds = FPlatformTime::Seconds() - SingleWeldStartSeconds;
+					for (int32 Index = 1; Index < SingleWeldBoxes.Num(); Index++)
+						TEST_TRUE_THROW(SingleWeldBoxes[Index]->IsWelded());
+
+					AddInfo(FString::Printf(TEXT("%d boxes: weld %.3f ms batched vs %.3f ms with WeldTo, compound sweep median %.0f ns welded vs %.0f ns unwelded"),
+						NumBoxes, BatchWeldSeconds * 1000.0, SingleWeldSeconds * 1000.0, WeldedStats.MedianNs, UnweldedStats.MedianNs));
+					RecordSweepBenchmark(*this, FString::Printf(TEXT("UBoxColliders-%d-Unwelded"), NumBoxes), UnweldedStats);
+					RecordSweepBenchmark(*this, FString::Printf(TEXT("UBoxColliders-%d-Welded"), NumBoxes), WeldedStats);
+				}
+				catch (...) {}
+			});
+	}
+
+	It("UBoxComponent sweeps against runtime-welded UBoxComponents", [this]()
+		{
+			try {
+				const FVector SweepStart = FVector{ 0, 0, 1000.f };
+				const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+				UWorld* World = Fixture.GetWorld();
+				TEST_NOT_NULL_THROW(World);
+				UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+				TEST_NOT_NULL_THROW(FloorPlaneCollider);
+
+				auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+				TEST_NOT_NULL_THROW(ActorClass);
+				auto Actor = World->SpawnActor<AActor>(ActorClass);
+				TEST_NOT_NULL_THROW(Actor);
+				TArray<UBoxComponent*> Boxes;
+				Actor->GetComponents(Boxes);
+				TEST_EQUAL_THROW(Boxes.Num(), 2);
+				Boxes[1]->WeldTo(Boxes[0]);
+
+				TArray<FHitResult> OutHits;
+				FComponentQueryParams Params;
+				Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+				Fixture.BeginSweeps();
+				TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+
+				const FSweepBenchmarkStats Stats = RunSweepBenchmark(GetNumBenchmarkSweeps(), [&]()
+					{
+						World->ComponentSweepMulti(OutHits, FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+					});
+				RecordSweepBenchmark(*this, TEXT("CubePair-UBoxColliders-Welded"), Stats);
+			}
+			catch (...) {}
+		});
+}
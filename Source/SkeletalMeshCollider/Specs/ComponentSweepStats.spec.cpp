@@ -0,0 +1,111 @@
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "ComponentSweepStats.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "ReusableComponentSweep.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+BEGIN_DEFINE_SPEC(FComponentSweepStatsSpec, "ComponentCollision.Instrumentation", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+
+	void AddStatsInfo(const FString& Name, const FComponentSweepStats& Stats);
+END_DEFINE_COMPONENT_COLLISION_SPEC(FComponentSweepStatsSpec)
+
+void FComponentSweepStatsSpec::AddStatsInfo(const FString& Name, const FComponentSweepStats& Stats)
+{
+	AddInfo(FString::Printf(TEXT("%s: %d bodies, %d shapes, %d candidates, %d hits; pose %.1f us, shape setup %.1f us, scene query %.1f us, finalize %.1f us"),
+		*Name, Stats.NumBodies, Stats.NumShapes, Stats.NumCandidates, Stats.NumHits,
+		Stats.PoseSeconds * 1e6, Stats.ShapeSetupSeconds * 1e6, Stats.SceneQuerySeconds * 1e6, Stats.FinalizeSeconds * 1e6));
+}
+
+void FComponentSweepStatsSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("Instrumentation")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("USkeletalMeshSweepSubsystem::GetLastSweepStats", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("USkeletalMeshComponent (%s) Sweep tests a single box shape of a single body"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+							TEST_NOT_NULL_THROW(Subsystem);
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(Component);
+
+							FComponentQueryParams Params;
+							Params.AddIgnoredActor(Component->GetOwner());
+							TArray<FHitResult> OutHits;
+							Fixture.BeginSweeps();
+							TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+
+							const FComponentSweepStats& Stats = Subsystem->GetLastSweepStats();
+							AddStatsInfo(Variant.Name, Stats);
+							TEST_EQUAL_THROW(Stats.NumBodies, 1);
+							TEST_EQUAL_THROW(Stats.NumShapes, 1);
+							TEST_TRUE_THROW(Stats.NumCandidates >= 1);
+							TEST_EQUAL_THROW(Stats.NumHits, OutHits.Num());
+							TEST_TRUE_THROW(Stats.PoseSeconds > 0.0);
+							TEST_TRUE_THROW(Stats.SceneQuerySeconds > 0.0);
+						}
+						catch (...) {}
+					});
+			}
+		});
+
+	Describe("FReusableComponentSweep::GetLastSweepStats", [this]()
+		{
+			for (const bool bWelded : { false, true })
+			{
+				It(FString::Printf(TEXT("UBoxCollider pair (%s) Sweep tests %s"), bWelded ? TEXT("runtime-welded") : TEXT("unwelded"), bWelded ? TEXT("both shapes of a single body") : TEXT("a single shape")), [this, bWelded]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+
+							auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+							TEST_NOT_NULL_THROW(ActorClass);
+							auto Actor = World->SpawnActor<AActor>(ActorClass);
+							TEST_NOT_NULL_THROW(Actor);
+							TArray<UBoxComponent*> Boxes;
+							Actor->GetComponents(Boxes);
+							TEST_EQUAL_THROW(Boxes.Num(), 2);
+							TEST_NOT_NULL_THROW(Boxes[0]);
+							TEST_NOT_NULL_THROW(Boxes[1]);
+							if (bWelded)
+								Boxes[1]->WeldTo(Boxes[0]);
+
+							FReusableComponentSweep Sweep;
+							const AActor* IgnoredActors[] = { Actor };
+							Sweep.SetIgnoredActors(IgnoredActors);
+							FComponentSweepHitBuffer OutHits;
+							Fixture.BeginSweeps();
+							TEST_TRUE_THROW(Sweep.Sweep(World, Boxes[0], SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), OutHits));
+
+							const FComponentSweepStats& Stats = Sweep.GetLastSweepStats();
+							AddStatsInfo(bWelded ? TEXT("Welded pair") : TEXT("Unwelded pair"), Stats);
+							TEST_EQUAL_THROW(Stats.NumBodies, 1);
+							TEST_EQUAL_THROW(Stats.NumShapes, bWelded ? 2 : 1);
+							TEST_TRUE_THROW(Stats.NumCandidates >= 1);
+							TEST_EQUAL_THROW(Stats.NumHits, OutHits.Num());
+						}
+						catch (...) {}
+					});
+			}
+		});
+}
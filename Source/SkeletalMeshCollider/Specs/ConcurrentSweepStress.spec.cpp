@@ -0,0 +1,407 @@
+#include "Async/Async.h"
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+
+namespace
+{
+	enum class EStressTarget : uint8
+	{
+		SkeletalMesh,
+		BoxPair,
+		Sphere,
+		Num
+	};
+
+	enum class EStressMutation : uint8
+	{
+		Weld,
+		Unweld,
+		PoseUpdate,
+		Num
+	};
+
+	const TCHAR* StressTargetNames[] = { TEXT("skeletal mesh"), TEXT("box pair"), TEXT("sphere") };
+	const TCHAR* StressMutationNames[] = { TEXT("weld"), TEXT("unweld"), TEXT("pose update") };
+
+	const int32 NumTargets = static_cast<int32>(EStressTarget::Num);
+	const int32 NumMutations = static_cast<int32>(EStressMutation::Num);
+
+	/** Lateral bone offsets cycled by the pose updates; the probe stays over the top face of the cube at all of them. */
+	const FVector PoseOffsets[] = { FVector{ 20.f, 0, 0 }, FVector{ 0, 20.f, 0 }, FVector{ -20.f, 0, 0 }, FVector::ZeroVector };
+	const float ProbeRadius = 10.f;
+
+	struct FStressSettings
+	{
+		double SecondsPerPass = 0.25;
+		int32 MaxWorkers = FMath::Max(FPlatformMisc::NumberOfCores(), 1);
+		int32 MaxReportedFailures = 10;
+
+		FStressSettings()
+		{
+			FParse::Value(FCommandLine::Get(), TEXT("ConcurrentSweepSeconds="), SecondsPerPass);
+			FParse::Value(FCommandLine::Get(), TEXT("ConcurrentSweepMaxWorkers="), MaxWorkers);
+			MaxWorkers = FMath::Max(MaxWorkers, 1);
+		}
+	};
+
+	/** A vertical sweep over one collider, and the hit it must return whatever the game thread does meanwhile. */
+	struct FStressColumn
+	{
+		EStressTarget Target = EStressTarget::SkeletalMesh;
+		FVector Start = FVector::ZeroVector;
+		FVector End = FVector::ZeroVector;
+		const AActor* ExpectedActor = nullptr;
+		float ExpectedDistance = 0.f;
+	};
+
+	struct FStressPose
+	{
+		USkeletalMeshComponent* Component = nullptr;
+		FName BoneName;
+		FVector RefPoseBodyLocation = FVector::ZeroVector;
+	};
+
+	struct FStressScene
+	{
+		TArray<FStressColumn> Columns;
+		TArray<FStressPose> Poses;
+		TArray<TArray<UBoxComponent*>> BoxPairs;
+	};
+
+	struct FStressPassResult
+	{
+		int32 NumWorkers = 0;
+		double Seconds = 0.0;
+		int32 NumSweeps = 0;
+		FSweepBenchmarkStats SweepStats[NumTargets];
+		FSweepBenchmarkStats MutationStats[NumMutations];
+	};
+
+	/** What a worker thread measured and saw go wrong; only the worker writes to it until it has been joined. */
+	struct FStressWorkerResult
+	{
+		TArray<double> SweepNs[NumTargets];
+		int32 NumSweeps = 0;
+		int32 NumFailures = 0;
+		TArray<FString> Failures;
+	};
+
+	/**
+	 * Sweeps random columns of Scene until bStop is set, checking every hit against the one of the quiet scene.
+	 * Workers use the engine scene queries, since USkeletalMeshSweepSubsystem is game thread only.
+	 */
+	void RunStressWorker(const UWorld* World, const FStressScene& Scene, int32 Seed, int32 MaxReportedFailures, const FThreadSafeBool& bStop, FStressWorkerResult& Result)
+	{
+		FRandomStream Random(Seed);
+		const FCollisionShape Probe = FCollisionShape::MakeSphere(ProbeRadius);
+		const double NsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+
+		while (!bStop)
+		{
+			const FStressColumn& Column = Scene.Columns[Random.RandHelper(Scene.Columns.Num())];
+			FHitResult Hit;
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			const bool bHit = World->SweepSingleByChannel(Hit, Column.Start, Column.End, FQuat::Identity, ECollisionChannel::ECC_Visibility, Probe);
+			Result.SweepNs[static_cast<int32>(Column.Target)].Add((FPlatformTime::Cycles64() - StartCycles) * NsPerCycle);
+			Result.NumSweeps++;
+
+			const AActor* HitActor = bHit ? Hit.GetActor() : nullptr;
+			if (HitActor != Column.ExpectedActor || !FMath::IsNearlyEqual(Hit.Distance, Column.ExpectedDistance, 0.1f))
+			{
+				if (Result.NumFailures++ < MaxReportedFailures)
+					Result.Failures.Add(FString::Printf(TEXT("Sweep over %s at %s hit %s at distance %f instead of %s at %f"), StressTargetNames[static_cast<int32>(Column.Target)], *Column.Start.ToString(),
+						HitActor ? *HitActor->GetName() : TEXT("nothing"), Hit.Distance, *Column.ExpectedActor->GetName(), Column.ExpectedDistance));
+			}
+		}
+	}
+}
+
+BEGIN_DEFINE_SPEC(FConcurrentSweepStressSpec, "ComponentCollision.ConcurrentSweeps", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+	FStressSettings Settings;
+
+	/** Spawns the four ref pose cubes, box pairs (half of them welded) and spheres on a grid, and records the hit over each. */
+	void SpawnStressScene(UWorld* World, FStressScene& Scene);
+
+	/**
+	 * Sweeps Scene from NumWorkers threads for the pass duration while the game thread keeps welding, unwelding
+	 * and posing it; a pass without workers times the game thread work uncontended.
+	 */
+	FStressPassResult RunStressPass(UWorld* World, FStressScene& Scene, int32 NumWorkers);
+
+	/** Applies the next weld or pose update to Scene, timing it into MutationNs; returns why it failed, if it did. */
+	FString MutateStressScene(FStressScene& Scene, int32 Step, TArray<double> (&MutationNs)[NumMutations]);
+
+	void ReportStressPasses(const TArray<FStressPassResult>& Passes);
+END_DEFINE_COMPONENT_COLLISION_SPEC(FConcurrentSweepStressSpec)
+
+void FConcurrentSweepStressSpec::SpawnStressScene(UWorld* World, FStressScene& Scene)
+{
+	const int32 CopiesPerVariant = 4;
+	const int32 NumBoxPairs = 8;
+	const int32 NumSpheres = 4;
+	const float Spacing = 600.f;
+
+	TEST_NOT_NULL_THROW(Fixture.GetFloor());
+	const float FloorTopZ = Fixture.GetFloorTopZ();
+
+	const int32 NumColumns = UE_ARRAY_COUNT(RefPoseCubeVariants) * CopiesPerVariant + NumBoxPairs + NumSpheres;
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumColumns)));
+	auto GridLocation = [&](int32 Index)
+	{
+		return FVector{ (Index % GridSize - (GridSize - 1) * 0.5f) * Spacing, (Index / GridSize - (GridSize - 1) * 0.5f) * Spacing, FloorTopZ + 400.f };
+	};
+
+	TArray<TPair<EStressTarget, const UPrimitiveComponent*>> Targets;
+	for (int32 Copy = 0; Copy < CopiesPerVariant; Copy++)
+	{
+		for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+		{
+			USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant, GridLocation(Targets.Num()));
+			TEST_NOT_NULL_THROW(Component);
+			const UPhysicsAsset* PhysicsAsset = Component->GetPhysicsAsset();
+			TEST_TRUE_THROW(PhysicsAsset && PhysicsAsset->SkeletalBodySetups.Num() > 0 && PhysicsAsset->SkeletalBodySetups[0]);
+
+			FStressPose& Pose = Scene.Poses.AddDefaulted_GetRef();
+			Pose.Component = Component;
+			Pose.BoneName = PhysicsAsset->SkeletalBodySetups[0]->BoneName;
+			const FBodyInstance* Body = Component->GetBodyInstance(Pose.BoneName);
+			TEST_NOT_NULL_THROW(Body);
+			Pose.RefPoseBodyLocation = Body->GetUnrealWorldTransform().GetLocation();
+			Targets.Emplace(EStressTarget::SkeletalMesh, Component);
+		}
+	}
+
+	auto BoxPairClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+	TEST_NOT_NULL_THROW(BoxPairClass);
+	for (int32 Index = 0; Index < NumBoxPairs; Index++)
+	{
+		auto Actor = World->SpawnActor<AActor>(BoxPairClass, GridLocation(Targets.Num()), FRotator::ZeroRotator);
+		TEST_NOT_NULL_THROW(Actor);
+		TArray<UBoxComponent*> Boxes;
+		Actor->GetComponents(Boxes);
+		TEST_EQUAL_THROW(Boxes.Num(), 2);
+		if (Index % 2 == 0)
+			Boxes[1]->WeldTo(Boxes[0]);
+		Scene.BoxPairs.Add(Boxes);
+
+		// The root box keeps its own shapes through welds; the child is re-created by UnWeldFromParent after its
+		// shapes leave the root, so a sweep over it can legitimately fall through in between
+		const FVector RootCenter = Boxes[0]->Bounds.Origin;
+		const FBox ChildBounds = Boxes[1]->Bounds.GetBox().ExpandBy(ProbeRadius);
+		TEST_FALSE_THROW(RootCenter.X > ChildBounds.Min.X && RootCenter.X < ChildBounds.Max.X && RootCenter.Y > ChildBounds.Min.Y && RootCenter.Y < ChildBounds.Max.Y);
+		Targets.Emplace(EStressTarget::BoxPair, Boxes[0]);
+	}
+
+	for (int32 Index = 0; Index < NumSpheres; Index++)
+	{
+		USphereComponent* Sphere = CreatePrimitiveCollider<USphereComponent>(World);
+		TEST_NOT_NULL_THROW(Sphere);
+		Sphere->SetSphereRadius(100.f);
+		Sphere->SetWorldLocation(GridLocation(Targets.Num()));
+		Targets.Emplace(EStressTarget::Sphere, Sphere);
+	}
+
+	// The expected hits are those of the quiet scene; welds and the lateral pose offsets don't change them
+	const FCollisionShape Probe = FCollisionShape::MakeSphere(ProbeRadius);
+	for (const TPair<EStressTarget, const UPrimitiveComponent*>& Target : Targets)
+	{
+		FStressColumn& Column = Scene.Columns.AddDefaulted_GetRef();
+		const FVector Center = Target.Value->Bounds.Origin;
+		Column.Target = Target.Key;
+		Column.Start = FVector{ Center.X, Center.Y, FloorTopZ + 3000.f };
+		Column.End = FVector{ Center.X, Center.Y, FloorTopZ - 100.f };
+		Column.ExpectedActor = Target.Value->GetOwner();
+
+		FHitResult Hit;
+		TEST_TRUE_THROW(World->SweepSingleByChannel(Hit, Column.Start, Column.End, FQuat::Identity, ECollisionChannel::ECC_Visibility, Probe));
+		TEST_TRUE_THROW(Hit.GetActor() == Column.ExpectedActor);
+		Column.ExpectedDistance = Hit.Distance;
+	}
+}
+
+FString FConcurrentSweepStressSpec::MutateStressScene(FStressScene& Scene, int32 Step, TArray<double> (&MutationNs)[NumMutations])
+{
+	const double NsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+	const int32 Index = Step / 2;
+
+	if (Step % 2 == 0)
+	{
+		const TArray<UBoxComponent*>& Boxes = Scene.BoxPairs[Index % Scene.BoxPairs.Num()];
+		const bool bWeld = Boxes[1]->BodyInstance.WeldParent == nullptr;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		if (bWeld)
+			Boxes[1]->WeldTo(Boxes[0]);
+		else
+			Boxes[1]->UnWeldFromParent();
+		MutationNs[static_cast<int32>(bWeld ? EStressMutation::Weld : EStressMutation::Unweld)].Add((FPlatformTime::Cycles64() - StartCycles) * NsPerCycle);
+
+		if ((Boxes[1]->BodyInstance.WeldParent == &Boxes[0]->BodyInstance) != bWeld)
+			return FString::Printf(TEXT("%s of %s didn't take"), bWeld ? TEXT("Weld") : TEXT("Unweld"), *Boxes[1]->GetOwner()->GetName());
+		return FString();
+	}
+
+	const FStressPose& Pose = Scene.Poses[Index % Scene.Poses.Num()];
+	const FVector Offset = PoseOffsets[(Index / Scene.Poses.Num()) % UE_ARRAY_COUNT(PoseOffsets)];
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	if (!SetBodyBoneOffset(Pose.Component, Offset))
+		return FString::Printf(TEXT("Unable to pose %s"), *Pose.Component->GetOwner()->GetName());
+	Pose.Component->UpdateKinematicBonesToAnim(Pose.Component->GetComponentSpaceTransforms(), ETeleportType::TeleportPhysics, true, EAllowKinematicDeferral::DisallowDeferral);
+	MutationNs[static_cast<int32>(EStressMutation::PoseUpdate)].Add((FPlatformTime::Cycles64() - StartCycles) * NsPerCycle);
+
+	const FBodyInstance* Body = Pose.Component->GetBodyInstance(Pose.BoneName);
+	if (!Body || !Body->GetUnrealWorldTransform().GetLocation().Equals(Pose.RefPoseBodyLocation + Offset, 0.1f))
+		return FString::Printf(TEXT("The body of %s didn't follow the pose to %s"), *Pose.Component->GetOwner()->GetName(), *(Pose.RefPoseBodyLocation + Offset).ToString());
+	return FString();
+}
+
+FStressPassResult FConcurrentSweepStressSpec::RunStressPass(UWorld* World, FStressScene& Scene, int32 NumWorkers)
+{
+	FStressPassResult Pass;
+	Pass.NumWorkers = NumWorkers;
+
+	TArray<FStressWorkerResult> WorkerResults;
+	WorkerResults.SetNum(NumWorkers);
+	FThreadSafeBool bStop(false);
+	TArray<TFuture<void>> Workers;
+	const double StartSeconds = FPlatformTime::Seconds();
+	for (int32 WorkerIndex = 0; WorkerIndex < NumWorkers; WorkerIndex++)
+	{
+		FStressWorkerResult* Result = &WorkerResults[WorkerIndex];
+		const int32 MaxReportedFailures = Settings.MaxReportedFailures;
+		Workers.Add(Async(EAsyncExecution::Thread, [World, &Scene, &bStop, Result, WorkerIndex, MaxReportedFailures]()
+			{
+				RunStressWorker(World, Scene, WorkerIndex + 1, MaxReportedFailures, bStop, *Result);
+			}));
+	}
+
+	// The workers must be joined before anything here can throw, since they read Scene and the world
+	TArray<double> MutationNs[NumMutations];
+	FString MutationFailure;
+	for (int32 Step = 0; MutationFailure.IsEmpty() && FPlatformTime::Seconds() - StartSeconds < Settings.SecondsPerPass; Step++)
+		MutationFailure = MutateStressScene(Scene, Step, MutationNs);
+
+	bStop = true;
+	for (TFuture<void>& Worker : Workers)
+		Worker.Wait();
+	Pass.Seconds = FPlatformTime::Seconds() - StartSeconds;
+
+	TArray<double> SweepNs[NumTargets];
+	TArray<FString> Failures;
+	int32 NumFailures = 0;
+	for (FStressWorkerResult& Result : WorkerResults)
+	{
+		Pass.NumSweeps += Result.NumSweeps;
+		for (int32 Target = 0; Target < NumTargets; Target++)
+			SweepNs[Target].Append(Result.SweepNs[Target]);
+		Failures.Append(Result.Failures);
+		NumFailures += Result.NumFailures;
+	}
+	for (int32 Index = 0; Index < FMath::Min(Failures.Num(), Settings.MaxReportedFailures); Index++)
+		AddError(FString::Printf(TEXT("%d workers: %s"), NumWorkers, *Failures[Index]));
+	for (int32 Target = 0; Target < NumTargets; Target++)
+		Pass.SweepStats[Target] = ComputeSweepBenchmarkStats(SweepNs[Target]);
+	for (int32 Mutation = 0; Mutation < NumMutations; Mutation++)
+		Pass.MutationStats[Mutation] = ComputeSweepBenchmarkStats(MutationNs[Mutation]);
+
+	if (!MutationFailure.IsEmpty())
+		AddError(FString::Printf(TEXT("%d workers: %s"), NumWorkers, *MutationFailure));
+	TEST_EQUAL_THROW(NumFailures, 0);
+	TEST_TRUE_THROW(MutationFailure.IsEmpty());
+	TEST_TRUE_THROW(NumWorkers == 0 || Pass.NumSweeps > 0);
+	return Pass;
+}
+
+void FConcurrentSweepStressSpec::ReportStressPasses(const TArray<FStressPassResult>& Passes)
+{
+	const FStressPassResult& Quiet = Passes[0];
+	const FStressPassResult& Single = Passes[1];
+	const double SingleThroughput = Single.NumSweeps / FMath::Max(Single.Seconds, 1e-6);
+	auto Ratio = [](double Value, double Reference) { return Reference > 0.0 ? Value / Reference : 0.0; };
+
+	// The slowdown of each kind of scene access relative to running without contention points at the locks it waits on
+	FString Hotspot;
+	double HotspotRatio = 0.0;
+	for (const FStressPassResult& Pass : Passes)
+	{
+		FString Line = FString::Printf(TEXT("%d workers: "), Pass.NumWorkers);
+		if (Pass.NumWorkers > 0)
+		{
+			const double Throughput = Pass.NumSweeps / FMath::Max(Pass.Seconds, 1e-6);
+			Line += FString::Printf(TEXT("%.0f sweeps/s (x%.2f of 1 worker); sweep p99"), Throughput, Ratio(Throughput, SingleThroughput));
+			for (int32 Target = 0; Target < NumTargets; Target++)
+			{
+				const double SweepRatio = Ratio(Pass.SweepStats[Target].P99Ns, Single.SweepStats[Target].P99Ns);
+				Line += FString::Printf(TEXT(" %s %.0f ns (x%.2f),"), StressTargetNames[Target], Pass.SweepStats[Target].P99Ns, SweepRatio);
+				if (SweepRatio > HotspotRatio)
+				{
+					HotspotRatio = SweepRatio;
+					Hotspot = FString::Printf(TEXT("sweeps over a %s with %d workers"), StressTargetNames[Target], Pass.NumWorkers);
+				}
+			}
+			Line += TEXT(" game thread p99");
+		}
+		else
+			Line += TEXT("uncontended game thread p99");
+
+		for (int32 Mutation = 0; Mutation < NumMutations; Mutation++)
+		{
+			const double MutationRatio = Ratio(Pass.MutationStats[Mutation].P99Ns, Quiet.MutationStats[Mutation].P99Ns);
+			Line += FString::Printf(TEXT(" %s %.0f ns (x%.2f)%s"), StressMutationNames[Mutation], Pass.MutationStats[Mutation].P99Ns, MutationRatio, Mutation + 1 < NumMutations ? TEXT(",") : TEXT(""));
+			if (Pass.NumWorkers > 0 && MutationRatio > HotspotRatio)
+			{
+				HotspotRatio = MutationRatio;
+				Hotspot = FString::Printf(TEXT("%s on the game thread with %d workers"), StressMutationNames[Mutation], Pass.NumWorkers);
+			}
+		}
+		AddInfo(Line);
+	}
+
+	if (!Hotspot.IsEmpty())
+		AddInfo(FString::Printf(TEXT("Most contended: %s, p99 x%.2f of uncontended"), *Hotspot, HotspotRatio));
+}
+
+void FConcurrentSweepStressSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("ConcurrentSweeps")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("UWorld::SweepSingleByChannel", [this]()
+		{
+			It("returns the quiet scene hits from every worker thread while the game thread welds and poses, from 1 worker to all cores", [this]()
+				{
+					try {
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+
+						FStressScene Scene;
+						SpawnStressScene(World, Scene);
+
+						Fixture.BeginSweeps();
+						TArray<FStressPassResult> Passes;
+						Passes.Add(RunStressPass(World, Scene, 0));
+						for (int32 NumWorkers = 1; ; NumWorkers = FMath::Min(NumWorkers * 2, Settings.MaxWorkers))
+						{
+							Passes.Add(RunStressPass(World, Scene, NumWorkers));
+							if (NumWorkers == Settings.MaxWorkers)
+								break;
+						}
+						ReportStressPasses(Passes);
+					}
+					catch (...) {}
+				});
+		});
+}
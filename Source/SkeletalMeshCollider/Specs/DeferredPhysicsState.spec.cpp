@@ -0,0 +1,114 @@
+#include "Animation/SkeletalMeshActor.h"
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "DeferredPhysicsStateSubsystem.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+BEGIN_DEFINE_SPEC(FDeferredPhysicsStateSpec, "ComponentCollision.DeferredPhysicsState", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FDeferredPhysicsStateSpec)
+
+void FDeferredPhysicsStateSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("DeferredPhysicsState")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("UDeferredPhysicsStateSubsystem", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("USkeletalMeshComponent (%s) first Sweep after a deferred spawn hits the floor"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+							TEST_NOT_NULL_THROW(FloorPlaneCollider);
+							auto DeferredPhysicsState = World->GetSubsystem<UDeferredPhysicsStateSubsystem>();
+							TEST_NOT_NULL_THROW(DeferredPhysicsState);
+							auto SweepSubsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+							TEST_NOT_NULL_THROW(SweepSubsystem);
+							auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(Variant.BlueprintClassPath);
+							TEST_NOT_NULL_THROW(ActorClass);
+
+							auto Actor = DeferredPhysicsState->SpawnActor<ASkeletalMeshActor>(ActorClass);
+							TEST_NOT_NULL_THROW(Actor);
+							USkeletalMeshComponent* Component = Actor->GetSkeletalMeshComponent();
+							TEST_TRUE_THROW(DeferredPhysicsState->IsPhysicsStateDeferred(*Component));
+							TEST_FALSE_THROW(Component->IsPhysicsStateCreated());
+
+							FComponentQueryParams Params;
+							Params.AddIgnoredActor(Actor);
+							TArray<FHitResult> OutHits;
+							Fixture.BeginSweeps();
+							TEST_TRUE_THROW(SweepSubsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+							TEST_TRUE_THROW(OutHits.Last().GetComponent() == FloorPlaneCollider);
+							TEST_EQUAL_TOLERANCE_THROW(OutHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
+
+							// From then on the bodies exist for engine queries too
+							TEST_FALSE_THROW(DeferredPhysicsState->IsPhysicsStateDeferred(*Component));
+							TEST_TRUE_THROW(Component->IsPhysicsStateCreated());
+							TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+							TEST_EQUAL_TOLERANCE_THROW(OutHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
+						}
+						catch (...) {}
+					});
+			}
+
+			It("prewarms deferred physics states in time-sliced batches", [this]()
+				{
+					try {
+						const int32 NumActors = 8;
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						auto DeferredPhysicsState = World->GetSubsystem<UDeferredPhysicsStateSubsystem>();
+						TEST_NOT_NULL_THROW(DeferredPhysicsState);
+						auto ActorClass = Fixture.LoadActorClass<ASkeletalMeshActor>(RefPoseCubeVariants[3].BlueprintClassPath);
+						TEST_NOT_NULL_THROW(ActorClass);
+
+						// Whatever earlier tests in this world left deferred goes first
+						DeferredPhysicsState->PrewarmDeferredPhysicsStates(MAX_dbl);
+						TEST_EQUAL_THROW(DeferredPhysicsState->GetNumDeferred(), 0);
+
+						TArray<USkeletalMeshComponent*> Components;
+						for (int32 Index = 0; Index < NumActors; Index++)
+						{
+							auto Actor = DeferredPhysicsState->SpawnActor<ASkeletalMeshActor>(ActorClass, FTransform(FVector{ Index * 500.f, 0, 0 }));
+							TEST_NOT_NULL_THROW(Actor);
+							Components.Add(Actor->GetSkeletalMeshComponent());
+						}
+						TEST_EQUAL_THROW(DeferredPhysicsState->GetNumDeferred(), NumActors);
+
+						auto NumCreated = [&Components]()
+						{
+							return Components.FilterByPredicate([](const USkeletalMeshComponent* Component) { return !Component->IsPendingKill() && Component->IsPhysicsStateCreated(); }).Num();
+						};
+
+						// A budget too small for anything still makes progress
+						TEST_EQUAL_THROW(DeferredPhysicsState->PrewarmDeferredPhysicsStates(1e-9), 1);
+						TEST_EQUAL_THROW(NumCreated(), 1);
+						TEST_EQUAL_THROW(DeferredPhysicsState->PrewarmDeferredPhysicsStates(0.0), 0);
+						TEST_EQUAL_THROW(NumCreated(), 1);
+
+						// Destroyed components are dropped rather than created
+						USkeletalMeshComponent* const* DestroyedComponent = Components.FindByPredicate([](const USkeletalMeshComponent* Component) { return !Component->IsPhysicsStateCreated(); });
+						TEST_NOT_NULL_THROW(DestroyedComponent);
+						(*DestroyedComponent)->GetOwner()->Destroy();
+						TEST_EQUAL_THROW(DeferredPhysicsState->PrewarmDeferredPhysicsStates(MAX_dbl), NumActors - 2);
+						TEST_EQUAL_THROW(DeferredPhysicsState->GetNumDeferred(), 0);
+						TEST_EQUAL_THROW(NumCreated(), NumActors - 1);
+					}
+					catch (...) {}
+				});
+		});
+}
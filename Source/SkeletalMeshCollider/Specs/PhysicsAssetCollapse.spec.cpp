@@ -0,0 +1,73 @@
+#include "CollapsedSkeletalMeshCollisionComponent.h"
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "PhysicsAssetCollapse.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+
+BEGIN_DEFINE_SPEC(FPhysicsAssetCollapseSpec, "ComponentCollision.PhysicsAssetCollapse", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FPhysicsAssetCollapseSpec)
+
+void FPhysicsAssetCollapseSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("PhysicsAssetCollapse")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("UCollapsedSkeletalMeshCollisionComponent", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("Sweep of the collapsed %s hits the floor from above like its USkeletalMeshComponent"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+							TEST_NOT_NULL_THROW(FloorPlaneCollider);
+
+							USkeletalMeshComponent* SkeletalMeshComponent = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(SkeletalMeshComponent);
+							USkeletalMesh* SkeletalMesh = SkeletalMeshComponent->SkeletalMesh;
+							TEST_NOT_NULL_THROW(SkeletalMesh);
+							TEST_NOT_NULL_THROW(SkeletalMesh->PhysicsAsset);
+							TEST_FALSE_THROW(FPhysicsAssetCollapse::CanCollapse(*SkeletalMesh, *SkeletalMesh->PhysicsAsset, false));
+							TEST_TRUE_THROW(FPhysicsAssetCollapse::CanCollapse(*SkeletalMesh, *SkeletalMesh->PhysicsAsset, true));
+
+							auto CollapsedComponent = CreatePrimitiveCollider<UCollapsedSkeletalMeshCollisionComponent>(World);
+							TEST_NOT_NULL_THROW(CollapsedComponent);
+							TEST_FALSE_THROW(CollapsedComponent->Bake());
+							CollapsedComponent->SetSkeletalMesh(SkeletalMesh);
+							TEST_FALSE_THROW(CollapsedComponent->IsBaked());
+							CollapsedComponent->SetSkeletalMeshNeverAnimates(true);
+							TEST_TRUE_THROW(CollapsedComponent->IsBaked());
+
+							FComponentQueryParams Params;
+							Params.AddIgnoredActor(SkeletalMeshComponent->GetOwner());
+							Params.AddIgnoredActor(CollapsedComponent->GetOwner());
+							Fixture.BeginSweeps();
+							TArray<FHitResult> CollapsedHits;
+							TEST_TRUE_THROW(World->ComponentSweepMulti(CollapsedHits, CollapsedComponent, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+							TEST_TRUE_THROW(CollapsedHits.Last().GetComponent() == FloorPlaneCollider);
+							TEST_EQUAL_TOLERANCE_THROW(CollapsedHits.Last().ImpactPoint.Z, Fixture.GetFloorTopZ(), 0.1f);
+							TEST_EQUAL_TOLERANCE_THROW(CollapsedHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
+
+							TArray<FHitResult> OutHits;
+							TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, SkeletalMeshComponent, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+							TEST_EQUAL_TOLERANCE_THROW(CollapsedHits.Last().ImpactPoint.Z, OutHits.Last().ImpactPoint.Z, 0.1f);
+							TEST_EQUAL_TOLERANCE_THROW(CollapsedHits.Last().Distance, OutHits.Last().Distance, 0.1f);
+						}
+						catch (...) {}
+					});
+			}
+		});
+}
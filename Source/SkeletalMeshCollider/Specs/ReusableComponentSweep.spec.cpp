@@ -0,0 +1,180 @@
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/AutomationTest.h"
+#include "ReusableComponentSweep.h"
+#include "Templates/Atomic.h"
+
+namespace
+{
+	/**
+	 * Allocator in front of GMalloc that counts the allocations made by one thread while a count is running.
+	 *
+	 * It is installed the first time it is needed and never removed or destroyed: other threads load GMalloc
+	 * without synchronization and may still be calling into it at any time. Outside of a count it only forwards,
+	 * and every call goes to the original allocator, so blocks from before the install can be freed through it.
+	 */
+	class FAllocationCounterMalloc : public FMalloc
+	{
+	public:
+		static FAllocationCounterMalloc& Get()
+		{
+			check(IsInGameThread());
+			static FAllocationCounterMalloc* Counter = nullptr;
+			if (!Counter)
+			{
+				Counter = new FAllocationCounterMalloc(GMalloc);
+				GMalloc = Counter;
+			}
+			return *Counter;
+		}
+
+		/** Starts counting the allocations of the calling thread. */
+		void BeginCount()
+		{
+			NumAllocations = 0;
+			CountedThreadId = FPlatformTLS::GetCurrentThreadId();
+		}
+
+		/** Stops counting and returns the number of allocations since BeginCount. */
+		int32 EndCount()
+		{
+			CountedThreadId = 0;
+			return NumAllocations;
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { InnerMalloc->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { InnerMalloc->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("AllocationCounter"); }
+
+	private:
+		explicit FAllocationCounterMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		void CountAllocation()
+		{
+			// Thread ids are never 0, so no thread counts outside of BeginCount and EndCount
+			if (FPlatformTLS::GetCurrentThreadId() == CountedThreadId)
+				NumAllocations++;
+		}
+
+		FMalloc* const InnerMalloc;
+		TAtomic<uint32> CountedThreadId{ 0 };
+		/** Only written by the counted thread. */
+		int32 NumAllocations = 0;
+	};
+
+	const int32 NumWarmupSweeps = 8;
+	const int32 NumCountedSweeps = 256;
+}
+
+BEGIN_DEFINE_SPEC(FReusableComponentSweepSpec, "ComponentCollision.ZeroAllocation", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+
+	int32 CountSteadyStateAllocations(UWorld* World, UPrimitiveComponent* Component, const FVector& SweepStart, const FVector& SweepEnd, float ExpectedImpactZ);
+END_DEFINE_COMPONENT_COLLISION_SPEC(FReusableComponentSweepSpec)
+
+int32 FReusableComponentSweepSpec::CountSteadyStateAllocations(UWorld* World, UPrimitiveComponent* Component, const FVector& SweepStart, const FVector& SweepEnd, float ExpectedImpactZ)
+{
+	FReusableComponentSweep Sweep;
+	const AActor* IgnoredActors[] = { Component->GetOwner() };
+	Sweep.SetIgnoredActors(IgnoredActors);
+	FComponentSweepHitBuffer OutHits;
+
+	for (int32 Index = 0; Index < NumWarmupSweeps; Index++)
+		Sweep.Sweep(World, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), OutHits);
+
+	int32 NumBlockingHits = 0;
+	int32 NumAllocations = 0;
+	FAllocationCounterMalloc& AllocationCounter = FAllocationCounterMalloc::Get();
+	AllocationCounter.BeginCount();
+	for (int32 Index = 0; Index < NumCountedSweeps; Index++)
+		NumBlockingHits += Sweep.Sweep(World, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), OutHits) ? 1 : 0;
+	NumAllocations = AllocationCounter.EndCount();
+
+	TestEqual(TEXT("Blocking hits"), NumBlockingHits, NumCountedSweeps);
+	if (OutHits.Num() > 0)
+		TestEqual(TEXT("ImpactPoint.Z"), OutHits.Last().ImpactPoint.Z, ExpectedImpactZ, 0.1f);
+	return NumAllocations;
+}
+
+void FReusableComponentSweepSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("ZeroAllocation")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("FReusableComponentSweep", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("USkeletalMeshComponent (%s) steady-state sweeps allocate nothing"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							TEST_NOT_NULL_THROW(Fixture.GetFloor());
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(Component);
+
+							Fixture.BeginSweeps();
+							const int32 NumAllocations = CountSteadyStateAllocations(World, Component, SweepStart, SweepEnd, Fixture.GetFloorTopZ());
+							TEST_EQUAL_THROW(NumAllocations, 0);
+						}
+						catch (...) {}
+					});
+			}
+
+			It("USphereComponent steady-state sweeps allocate nothing", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						TEST_NOT_NULL_THROW(Fixture.GetFloor());
+						USphereComponent* Component = CreatePrimitiveCollider<USphereComponent>(World);
+						TEST_NOT_NULL_THROW(Component);
+						Component->SetSphereRadius(100.f);
+
+						Fixture.BeginSweeps();
+						const int32 NumAllocations = CountSteadyStateAllocations(World, Component, SweepStart, SweepEnd, Fixture.GetFloorTopZ());
+						TEST_EQUAL_THROW(NumAllocations, 0);
+					}
+					catch (...) {}
+				});
+		});
+}
@@ -0,0 +1,123 @@
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Misc/AutomationTest.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "SkeletalMeshBodyShapeCache.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+namespace
+{
+	/** Bytes tracked under the PhysX tag of the low level memory tracker, or -1 when it isn't running (-llm). */
+	int64 GetTrackedPhysicsMemory()
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		if (FLowLevelMemTracker::IsEnabled())
+			return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, ELLMTag::PhysX);
+#endif
+		return -1;
+	}
+
+	/** Adds the body setups of the bodies of Component to BodySetups. */
+	void GatherBodySetups(const USkeletalMeshComponent& Component, TSet<UBodySetup*>& BodySetups)
+	{
+		for (const FBodyInstance* Body : Component.Bodies)
+			if (Body && Body->BodySetup.IsValid())
+				BodySetups.Add(Body->BodySetup.Get());
+	}
+
+	/** Bytes of cooked collision geometry, the convex and triangle meshes the engine creates, held by BodySetups. */
+	SIZE_T GetCookedGeometrySize(const TSet<UBodySetup*>& BodySetups)
+	{
+		SIZE_T Size = 0;
+		for (UBodySetup* BodySetup : BodySetups)
+			Size += BodySetup->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		return Size;
+	}
+}
+
+/** A memory report over 10000 spawns per variant, so a performance test kept out of the specs run on every commit. */
+BEGIN_DEFINE_SPEC(FSharedBodyShapesSpec, "ComponentCollision.SharedBodyShapes", EAutomationTestFlags::PerfFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FSharedBodyShapesSpec)
+
+void FSharedBodyShapesSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("SharedBodyShapes")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("FSharedBodyShapesRegistry", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				// The engine geometry is asserted on through the body setups: every instance must create its bodies from
+				// the body setups of the physics asset, so the cooked convex and triangle meshes, scaled per shape
+				// rather than copied, stay the same however many instances there are. Each instance still gets its own
+				// physics actor and shapes, which grow linearly; they are reported per instance when the low level
+				// memory tracker runs.
+				It(FString::Printf(TEXT("shares the cooked body geometry and one body shape set between 10000 USkeletalMeshComponents (%s)"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const int32 NumInstances = 10000;
+							const float Spacing = 500.f;
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+							TEST_NOT_NULL_THROW(Subsystem);
+
+							// The registry is global, so only growth from here on belongs to this test
+							const FSharedBodyShapesRegistry& Registry = FSharedBodyShapesRegistry::Get();
+							const int32 NumSharedBefore = Registry.GetNumShared();
+							const SIZE_T SharedSizeBefore = Registry.GetSharedAllocatedSize();
+							const int64 PhysicsMemoryBefore = GetTrackedPhysicsMemory();
+
+							const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumInstances)));
+							const FSharedBodyShapes* FirstShared = nullptr;
+							const UPhysicsAsset* PhysicsAsset = nullptr;
+							TSet<UBodySetup*> BodySetups;
+							SIZE_T FirstCookedGeometrySize = 0;
+							for (int32 Index = 0; Index < NumInstances; Index++)
+							{
+								const FVector Location{ (Index % GridSize) * Spacing, (Index / GridSize) * Spacing, 0.f };
+								USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant, Location);
+								TEST_NOT_NULL_THROW(Component);
+								if (!PhysicsAsset)
+									PhysicsAsset = Component->GetPhysicsAsset();
+								TEST_NOT_NULL_THROW(PhysicsAsset);
+								TEST_TRUE_THROW(Component->GetPhysicsAsset() == PhysicsAsset);
+								GatherBodySetups(*Component, BodySetups);
+								if (Index == 0)
+									FirstCookedGeometrySize = GetCookedGeometrySize(BodySetups);
+								const FSkeletalMeshBodyShapeCache& BodyShapes = Subsystem->GetBodyShapes(*Component);
+								TEST_NOT_NULL_THROW(BodyShapes.GetShared().Get());
+								if (!FirstShared)
+									FirstShared = BodyShapes.GetShared().Get();
+								TEST_TRUE_THROW(BodyShapes.GetShared().Get() == FirstShared);
+							}
+							TEST_EQUAL_THROW(Registry.GetNumShared() - NumSharedBefore, 1);
+							TEST_EQUAL_THROW(BodySetups.Num(), PhysicsAsset->SkeletalBodySetups.Num());
+							const SIZE_T CookedGeometrySize = GetCookedGeometrySize(BodySetups);
+							TEST_TRUE_THROW(CookedGeometrySize == FirstCookedGeometrySize);
+
+							const SIZE_T SharedSize = Registry.GetSharedAllocatedSize() - SharedSizeBefore;
+							AddInfo(FString::Printf(TEXT("%s: %d instances share %d body setups with %llu bytes of cooked geometry, and 1 body shape set of %llu bytes, with %llu bytes of cache per instance"),
+								Variant.Name, NumInstances, BodySetups.Num(), static_cast<uint64>(CookedGeometrySize), static_cast<uint64>(SharedSize), static_cast<uint64>(sizeof(FSkeletalMeshBodyShapeCache))));
+
+							const int64 PhysicsMemoryAfter = GetTrackedPhysicsMemory();
+							if (PhysicsMemoryBefore >= 0 && PhysicsMemoryAfter >= 0)
+								AddInfo(FString::Printf(TEXT("%s: %lld bytes of engine physics memory per instance"), Variant.Name, (PhysicsMemoryAfter - PhysicsMemoryBefore) / NumInstances));
+							else
+								AddInfo(TEXT("Engine physics memory is not measured; run with -llm to report it"));
+						}
+						catch (...) {}
+					});
+			}
+		});
+}
@@ -0,0 +1,187 @@
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+BEGIN_DEFINE_SPEC(FSkeletalMeshBodyShapeCacheSpec, "ComponentCollision.BodyShapeCache", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FSkeletalMeshBodyShapeCacheSpec)
+
+void FSkeletalMeshBodyShapeCacheSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("BodyShapeCache")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("USkeletalMeshSweepSubsystem::ComponentSweepMulti", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("USkeletalMeshComponent (%s) Sweep hits the floor from above like UWorld::ComponentSweepMulti"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							TEST_NOT_NULL_THROW(Fixture.GetFloor());
+							auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+							TEST_NOT_NULL_THROW(Subsystem);
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(Component);
+
+							FComponentQueryParams Params;
+							Params.AddIgnoredActor(Component->GetOwner());
+							Fixture.BeginSweeps();
+							TArray<FHitResult> CachedHits;
+							bool HitFound = Subsystem->ComponentSweepMulti(CachedHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params);
+							TEST_TRUE_THROW(HitFound);
+							TEST_TRUE_THROW(Subsystem->GetBodyShapes(*Component).IsSupported());
+							TEST_EQUAL_TOLERANCE_THROW(CachedHits.Last().ImpactPoint.Z, Fixture.GetFloorTopZ(), 0.1f);
+							TEST_EQUAL_TOLERANCE_THROW(CachedHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
+
+							TArray<FHitResult> OutHits;
+							TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+							TEST_EQUAL_TOLERANCE_THROW(CachedHits.Last().ImpactPoint.Z, OutHits.Last().ImpactPoint.Z, 0.1f);
+							TEST_EQUAL_TOLERANCE_THROW(CachedHits.Last().Distance, OutHits.Last().Distance, 0.1f);
+							TEST_EQUAL_TOLERANCE_THROW(CachedHits.Last().Location, OutHits.Last().Location, 0.1f);
+						}
+						catch (...) {}
+					});
+			}
+
+			It("rebuilds the body shapes only when the component scale or pose changes", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						TEST_NOT_NULL_THROW(Fixture.GetFloor());
+						auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+
+						const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+						TEST_NOT_NULL_THROW(Component);
+
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Component->GetOwner());
+						TArray<FHitResult> OutHits;
+						Fixture.BeginSweeps();
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_EQUAL_THROW(Subsystem->GetBodyShapes(*Component).GetNumRebuilds(), 1);
+
+						// Moving the component leaves the component space shapes untouched
+						Component->GetOwner()->SetActorLocation(FVector{ 100.f, 0, 0 });
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_EQUAL_THROW(Subsystem->GetBodyShapes(*Component).GetNumRebuilds(), 1);
+
+						Component->SetWorldScale3D(FVector{ 0.5f, 0.5f, 0.5f });
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_EQUAL_THROW(Subsystem->GetBodyShapes(*Component).GetNumRebuilds(), 2);
+						TEST_EQUAL_TOLERANCE_THROW(OutHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart, 0.5f), 0.1f);
+					}
+					catch (...) {}
+				});
+
+			It("updates only the shapes of a moved bone, once per pose", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+						const FVector BoneOffset = FVector{ 0, 0, 50.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						TEST_NOT_NULL_THROW(Fixture.GetFloor());
+						auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+
+						const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+						TEST_NOT_NULL_THROW(Component);
+						USkeletalMeshComponent* OtherComponent = Fixture.SpawnRefPoseCube(Variant);
+						TEST_NOT_NULL_THROW(OtherComponent);
+
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Component->GetOwner());
+						Params.AddIgnoredActor(OtherComponent->GetOwner());
+						TArray<FHitResult> OutHits;
+						Fixture.BeginSweeps();
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, OtherComponent, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_TRUE_THROW(Subsystem->GetBodyShapes(*Component).GetShared() == Subsystem->GetBodyShapes(*OtherComponent).GetShared());
+
+						TEST_TRUE_THROW(SetBodyBoneOffset(Component, BoneOffset));
+						for (int32 Index = 0; Index < 3; Index++)
+						{
+							TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+							TEST_EQUAL_TOLERANCE_THROW(OutHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart) + BoneOffset.Z, 0.1f);
+						}
+						TEST_EQUAL_THROW(Subsystem->GetBodyShapes(*Component).GetNumRebuilds(), 1);
+						TEST_EQUAL_THROW(Subsystem->GetBodyShapes(*Component).GetNumBodyUpdates(), 1);
+
+						// The other instance keeps the shapes of the ref pose
+						TEST_TRUE_THROW(Subsystem->GetBodyShapes(*Component).GetShared() != Subsystem->GetBodyShapes(*OtherComponent).GetShared());
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, OtherComponent, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_EQUAL_TOLERANCE_THROW(OutHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
+					}
+					catch (...) {}
+				});
+
+			It("updates the world bounds of a body only when its bone or the component moves", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+						const FVector BoneOffset = FVector{ 0, 0, 50.f };
+						const FVector ComponentOffset = FVector{ 100.f, 0, 0 };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+
+						const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+						TEST_NOT_NULL_THROW(Component);
+
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Component->GetOwner());
+						TArray<FHitResult> OutHits;
+						Fixture.BeginSweeps();
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						const FSkeletalMeshBodyShapeCache& BodyShapes = Subsystem->GetBodyShapes(*Component);
+						TEST_EQUAL_THROW(BodyShapes.GetBodyWorldBounds().Num(), 1);
+						const FBox RefPoseBounds = BodyShapes.GetBodyWorldBounds()[0];
+						TEST_EQUAL_TOLERANCE_THROW(RefPoseBounds.Min.Z, -Variant.GetCubeHalfZExtent(), 0.1f);
+						TEST_EQUAL_TOLERANCE_THROW(RefPoseBounds.Max.Z, Variant.GetCubeHalfZExtent(), 0.1f);
+						TEST_EQUAL_THROW(BodyShapes.GetNumBodyBoundsUpdates(), 1);
+
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_EQUAL_THROW(BodyShapes.GetNumBodyBoundsUpdates(), 1);
+
+						TEST_TRUE_THROW(SetBodyBoneOffset(Component, BoneOffset));
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_EQUAL_TOLERANCE_THROW(BodyShapes.GetBodyWorldBounds()[0].Min, RefPoseBounds.Min + BoneOffset, 0.1f);
+						TEST_EQUAL_TOLERANCE_THROW(BodyShapes.GetBodyWorldBounds()[0].Max, RefPoseBounds.Max + BoneOffset, 0.1f);
+						TEST_EQUAL_THROW(BodyShapes.GetNumBodyBoundsUpdates(), 2);
+
+						Component->GetOwner()->SetActorLocation(ComponentOffset);
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_EQUAL_TOLERANCE_THROW(BodyShapes.GetBodyWorldBounds()[0].Min, RefPoseBounds.Min + BoneOffset + ComponentOffset, 0.1f);
+						TEST_EQUAL_TOLERANCE_THROW(BodyShapes.GetBodyWorldBounds()[0].Max, RefPoseBounds.Max + BoneOffset + ComponentOffset, 0.1f);
+						TEST_EQUAL_THROW(BodyShapes.GetNumBodyBoundsUpdates(), 3);
+					}
+					catch (...) {}
+				});
+		});
+}
@@ -0,0 +1,290 @@
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "SkeletalMeshBodyTreeSubsystem.h"
+
+BEGIN_DEFINE_SPEC(FSkeletalMeshBodyTreeSpec, "ComponentCollision.BodyTree", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FSkeletalMeshBodyTreeSpec)
+
+void FSkeletalMeshBodyTreeSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("BodyTree")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("USkeletalMeshBodyTreeSubsystem", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("Sphere Sweep hits a registered USkeletalMeshComponent (%s) where the world hit it before"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+							const FCollisionShape SweepShape = FCollisionShape::MakeSphere(50.f);
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+							TEST_NOT_NULL_THROW(FloorPlaneCollider);
+							auto Subsystem = World->GetSubsystem<USkeletalMeshBodyTreeSubsystem>();
+							TEST_NOT_NULL_THROW(Subsystem);
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(Component);
+
+							Fixture.BeginSweeps();
+							FHitResult WorldHit;
+							TEST_TRUE_THROW(World->SweepSingleByChannel(WorldHit, SweepStart, SweepEnd, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+							TEST_TRUE_THROW(WorldHit.GetComponent() == Component);
+
+							TEST_TRUE_THROW(Subsystem->RegisterComponent(Component));
+							Subsystem->Refit();
+							TEST_EQUAL_THROW(Subsystem->GetTree().GetNumLeaves(), 1);
+
+							// The body has left the scene queries, so the world alone now hits the floor
+							FHitResult FloorHit;
+							TEST_TRUE_THROW(World->SweepSingleByChannel(FloorHit, SweepStart, SweepEnd, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+							TEST_TRUE_THROW(FloorHit.GetComponent() == FloorPlaneCollider);
+
+							FHitResult TreeHit;
+							TEST_TRUE_THROW(Subsystem->SweepSingleByChannel(TreeHit, SweepStart, SweepEnd, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+							TEST_TRUE_THROW(TreeHit.GetComponent() == Component);
+							TEST_EQUAL_TOLERANCE_THROW(TreeHit.ImpactPoint, WorldHit.ImpactPoint, 0.1f);
+							TEST_EQUAL_TOLERANCE_THROW(TreeHit.Distance, WorldHit.Distance, 0.1f);
+
+							// Refitting follows the component without a rebuild
+							Component->GetOwner()->SetActorLocation(FVector{ 300.f, 0, 0 });
+							Subsystem->Refit();
+							TEST_TRUE_THROW(Subsystem->SweepSingleByChannel(TreeHit, SweepStart + FVector{ 300.f, 0, 0 }, SweepEnd + FVector{ 300.f, 0, 0 }, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+							TEST_TRUE_THROW(TreeHit.GetComponent() == Component);
+							TEST_EQUAL_TOLERANCE_THROW(TreeHit.Distance, WorldHit.Distance, 0.1f);
+
+							Subsystem->UnregisterComponent(Component);
+							TEST_TRUE_THROW(Component->IsQueryCollisionEnabled());
+						}
+						catch (...) {}
+					});
+			}
+
+			It("refits a registered USkeletalMeshComponent (Cube-ScaledAndRotatedRefPose) from the cached bounds of the bodies whose bone moved", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+						const FCollisionShape SweepShape = FCollisionShape::MakeSphere(50.f);
+						const FVector BoneOffset = FVector{ 0, 0, 50.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						auto Subsystem = World->GetSubsystem<USkeletalMeshBodyTreeSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[3]);
+						TEST_NOT_NULL_THROW(Component);
+						TEST_TRUE_THROW(Subsystem->FindBodyShapes(Component) == nullptr);
+
+						TEST_TRUE_THROW(Subsystem->RegisterComponent(Component));
+						Subsystem->Refit();
+						const FSkeletalMeshBodyShapeCache* BodyShapes = Subsystem->FindBodyShapes(Component);
+						TEST_NOT_NULL_THROW(BodyShapes);
+						TEST_EQUAL_THROW(BodyShapes->GetBodyWorldBounds().Num(), 1);
+						TEST_EQUAL_THROW(BodyShapes->GetNumBodyBoundsUpdates(), 1);
+						const FBox RefPoseBounds = BodyShapes->GetBodyWorldBounds()[0];
+
+						// Nothing moved, so refitting only compares the bone transforms
+						Subsystem->Refit();
+						TEST_EQUAL_THROW(BodyShapes->GetNumBodyBoundsUpdates(), 1);
+
+						TEST_TRUE_THROW(SetBodyBoneOffset(Component, BoneOffset));
+						Subsystem->Refit();
+						TEST_EQUAL_THROW(BodyShapes->GetNumBodyBoundsUpdates(), 2);
+						TEST_EQUAL_TOLERANCE_THROW(BodyShapes->GetBodyWorldBounds()[0].Min, RefPoseBounds.Min + BoneOffset, 0.1f);
+						TEST_EQUAL_TOLERANCE_THROW(BodyShapes->GetBodyWorldBounds()[0].Max, RefPoseBounds.Max + BoneOffset, 0.1f);
+
+						Fixture.BeginSweeps();
+						FHitResult TreeHit;
+						TEST_TRUE_THROW(Subsystem->SweepSingleByChannel(TreeHit, SweepStart, SweepEnd, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+						TEST_TRUE_THROW(TreeHit.GetComponent() == Component);
+						Subsystem->UnregisterComponent(Component);
+					}
+					catch (...) {}
+				});
+
+			It("ComponentSweepMulti of a USphereComponent hits a registered USkeletalMeshComponent (Cube-ScaledAndRotatedRefPose)", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						auto Subsystem = World->GetSubsystem<USkeletalMeshBodyTreeSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[3]);
+						TEST_NOT_NULL_THROW(Component);
+						USphereComponent* Sphere = CreatePrimitiveCollider<USphereComponent>(World);
+						TEST_NOT_NULL_THROW(Sphere);
+						Sphere->SetSphereRadius(50.f);
+
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Sphere->GetOwner());
+						Fixture.BeginSweeps();
+						TArray<FHitResult> WorldHits;
+						TEST_TRUE_THROW(World->ComponentSweepMulti(WorldHits, Sphere, SweepStart, SweepEnd, FQuat::Identity, Params));
+
+						Subsystem->RegisterComponent(Component);
+						TArray<FHitResult> TreeHits;
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(TreeHits, Sphere, SweepStart, SweepEnd, FQuat::Identity, Params));
+						TEST_TRUE_THROW(TreeHits.Last().GetComponent() == WorldHits.Last().GetComponent());
+						TEST_EQUAL_TOLERANCE_THROW(TreeHits.Last().ImpactPoint, WorldHits.Last().ImpactPoint, 0.1f);
+						TEST_EQUAL_TOLERANCE_THROW(TreeHits.Last().Distance, WorldHits.Last().Distance, 0.1f);
+						Subsystem->UnregisterComponent(Component);
+					}
+					catch (...) {}
+				});
+
+			It("ComponentSweepMulti of a registered USkeletalMeshComponent (Cube-ScaledAndRotatedRefPose) never hits the component itself", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+						const FRefPoseCubeVariant& Variant = RefPoseCubeVariants[3];
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+						TEST_NOT_NULL_THROW(FloorPlaneCollider);
+						auto Subsystem = World->GetSubsystem<USkeletalMeshBodyTreeSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+						TEST_NOT_NULL_THROW(Component);
+						TEST_TRUE_THROW(Subsystem->RegisterComponent(Component));
+
+						// No ignored actor: the tree holds the swept component, which must still not hit itself
+						TArray<FHitResult> OutHits;
+						Fixture.BeginSweeps();
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat::Identity, FComponentQueryParams()));
+						for (const FHitResult& Hit : OutHits)
+							TEST_FALSE_THROW(Hit.GetComponent() == Component);
+						TEST_TRUE_THROW(OutHits.Last().GetComponent() == FloorPlaneCollider);
+						TEST_EQUAL_TOLERANCE_THROW(OutHits.Last().Distance, Fixture.ExpectedFloorHitDistance(Variant, SweepStart), 0.1f);
+						Subsystem->UnregisterComponent(Component);
+					}
+					catch (...) {}
+				});
+
+			It("ComponentSweepMulti of runtime-welded UBoxColliders sweeps the welded shapes like UWorld::ComponentSweepMulti", [this]()
+				{
+					try {
+						const FVector SweepDelta = FVector{ 0, 0, -2000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						TEST_NOT_NULL_THROW(Fixture.GetFloor());
+						auto Subsystem = World->GetSubsystem<USkeletalMeshBodyTreeSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+						TEST_NOT_NULL_THROW(ActorClass);
+						auto Actor = World->SpawnActor<AActor>(ActorClass);
+						TEST_NOT_NULL_THROW(Actor);
+						TArray<UBoxComponent*> Boxes;
+						Actor->GetComponents(Boxes);
+						TEST_EQUAL_THROW(Boxes.Num(), 2);
+						Boxes[1]->WeldTo(Boxes[0]);
+						TEST_TRUE_THROW(Boxes[1]->IsWelded());
+
+						const FVector SweepStart = Boxes[0]->GetComponentLocation();
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Actor);
+						Fixture.BeginSweeps();
+						TArray<FHitResult> WorldHits;
+						TEST_TRUE_THROW(World->ComponentSweepMulti(WorldHits, Boxes[0], SweepStart, SweepStart + SweepDelta, Boxes[0]->GetComponentQuat(), Params));
+						TArray<FHitResult> TreeHits;
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(TreeHits, Boxes[0], SweepStart, SweepStart + SweepDelta, Boxes[0]->GetComponentQuat(), Params));
+						TEST_TRUE_THROW(TreeHits.Last().GetComponent() == WorldHits.Last().GetComponent());
+						TEST_EQUAL_TOLERANCE_THROW(TreeHits.Last().ImpactPoint, WorldHits.Last().ImpactPoint, 0.1f);
+						TEST_EQUAL_TOLERANCE_THROW(TreeHits.Last().Distance, WorldHits.Last().Distance, 0.1f);
+					}
+					catch (...) {}
+				});
+
+			It("leaves engine queries against unregistered USkeletalMeshComponents unchanged", [this]()
+				{
+					try {
+						const FVector SweepDelta = FVector{ 0, 0, -2000.f };
+						const FVector UnregisteredLocation = FVector{ 500.f, 0, 0 };
+						const FCollisionShape SweepShape = FCollisionShape::MakeSphere(50.f);
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+						TEST_NOT_NULL_THROW(FloorPlaneCollider);
+						auto Subsystem = World->GetSubsystem<USkeletalMeshBodyTreeSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						USkeletalMeshComponent* Registered = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[0]);
+						TEST_NOT_NULL_THROW(Registered);
+						USkeletalMeshComponent* Unregistered = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[0], UnregisteredLocation);
+						TEST_NOT_NULL_THROW(Unregistered);
+						TEST_TRUE_THROW(Subsystem->RegisterComponent(Registered));
+						Subsystem->Refit();
+
+						// Registering opts the component out of engine queries; its neighbour must not be affected
+						Fixture.BeginSweeps();
+						const FVector UnregisteredSweepStart = UnregisteredLocation + FVector{ 0, 0, 1000.f };
+						FHitResult WorldHit;
+						TEST_TRUE_THROW(World->SweepSingleByChannel(WorldHit, UnregisteredSweepStart, UnregisteredSweepStart + SweepDelta, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+						TEST_TRUE_THROW(WorldHit.GetComponent() == Unregistered);
+
+						const FVector RegisteredSweepStart = FVector{ 0, 0, 1000.f };
+						TEST_TRUE_THROW(World->SweepSingleByChannel(WorldHit, RegisteredSweepStart, RegisteredSweepStart + SweepDelta, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+						TEST_TRUE_THROW(WorldHit.GetComponent() == FloorPlaneCollider);
+
+						FHitResult TreeHit;
+						TEST_TRUE_THROW(Subsystem->SweepSingleByChannel(TreeHit, UnregisteredSweepStart, UnregisteredSweepStart + SweepDelta, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+						TEST_TRUE_THROW(TreeHit.GetComponent() == Unregistered);
+						Subsystem->UnregisterComponent(Registered);
+					}
+					catch (...) {}
+				});
+
+			It("only registers USkeletalMeshComponents with query collision, and restores their collision when unregistered", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+						const FCollisionShape SweepShape = FCollisionShape::MakeSphere(50.f);
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						auto Subsystem = World->GetSubsystem<USkeletalMeshBodyTreeSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[0]);
+						TEST_NOT_NULL_THROW(Component);
+
+						for (const ECollisionEnabled::Type CollisionEnabled : { ECollisionEnabled::NoCollision, ECollisionEnabled::PhysicsOnly })
+						{
+							Component->SetCollisionEnabled(CollisionEnabled);
+							TEST_FALSE_THROW(Subsystem->RegisterComponent(Component));
+							TEST_EQUAL_THROW(Subsystem->GetNumComponents(), 0);
+							TEST_EQUAL_THROW(Component->GetCollisionEnabled(), CollisionEnabled);
+						}
+
+						Component->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+						TEST_TRUE_THROW(Subsystem->RegisterComponent(Component));
+						TEST_EQUAL_THROW(Component->GetCollisionEnabled(), ECollisionEnabled::NoCollision);
+						FHitResult TreeHit;
+						TEST_TRUE_THROW(Subsystem->SweepSingleByChannel(TreeHit, SweepStart, SweepEnd, FQuat::Identity, ECollisionChannel::ECC_Visibility, SweepShape));
+						TEST_TRUE_THROW(TreeHit.GetComponent() == Component);
+
+						Subsystem->UnregisterComponent(Component);
+						TEST_EQUAL_THROW(Component->GetCollisionEnabled(), ECollisionEnabled::QueryOnly);
+					}
+					catch (...) {}
+				});
+		});
+}
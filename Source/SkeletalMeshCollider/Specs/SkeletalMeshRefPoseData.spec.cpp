@@ -0,0 +1,98 @@
+#include "AnimationRuntime.h"
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "PhysicsAssetCollapse.h"
+#include "ReferenceSkeleton.h"
+#include "SkeletalMeshRefPoseData.h"
+#include "UObject/Package.h"
+
+namespace
+{
+	/** Replaces the skeleton of SkeletalMesh with a root bone and one child. */
+	void SetTwoBoneRefSkeleton(USkeletalMesh& SkeletalMesh, FName ChildBoneName, const FVector& ChildLocation)
+	{
+		SkeletalMesh.RefSkeleton.Empty();
+		FReferenceSkeletonModifier Modifier(SkeletalMesh.RefSkeleton, nullptr);
+		Modifier.Add(FMeshBoneInfo(TEXT("Root"), TEXT("Root"), INDEX_NONE), FTransform::Identity);
+		Modifier.Add(FMeshBoneInfo(ChildBoneName, ChildBoneName.ToString(), 0), FTransform(ChildLocation));
+	}
+}
+
+BEGIN_DEFINE_SPEC(FSkeletalMeshRefPoseDataSpec, "ComponentCollision.RefPoseData", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FSkeletalMeshRefPoseDataSpec)
+
+void FSkeletalMeshRefPoseDataSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("RefPoseData")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("USkeletalMeshRefPoseData", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("USkeletalMesh (%s) bakes its component space ref pose and the collider extents generated from its FBX source"), Variant.Name), [this, Variant]()
+					{
+						try {
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(Component);
+							USkeletalMesh* SkeletalMesh = Component->SkeletalMesh;
+							TEST_NOT_NULL_THROW(SkeletalMesh);
+							TEST_NOT_NULL_THROW(SkeletalMesh->PhysicsAsset);
+
+							if (!USkeletalMeshRefPoseData::Find(*SkeletalMesh))
+								AddWarning(FString::Printf(TEXT("%s has no ref pose data; run SkeletalMeshRefPoseData.Bake /Game/ComponentCollision"), *SkeletalMesh->GetPathName()));
+
+							// Baked into an object of its own, so that the shared content later specs load stays as it is
+							USkeletalMeshRefPoseData* RefPoseData = NewObject<USkeletalMeshRefPoseData>(GetTransientPackage());
+							TEST_NOT_NULL_THROW(RefPoseData);
+							RefPoseData->BakeFrom(*SkeletalMesh);
+
+							const FReferenceSkeleton& RefSkeleton = SkeletalMesh->GetRefSkeleton();
+							TEST_EQUAL_THROW(RefPoseData->ComponentSpaceRefPose.Num(), RefSkeleton.GetNum());
+							for (int32 BoneIndex = 0; BoneIndex < RefSkeleton.GetNum(); BoneIndex++)
+								TEST_TRUE_THROW(RefPoseData->ComponentSpaceRefPose[BoneIndex].Equals(FAnimationRuntime::GetComponentSpaceTransformRefPose(RefSkeleton, BoneIndex), 0.01f));
+
+							TArray<FTransform> ComponentSpaceRefPose;
+							FPhysicsAssetCollapse::GetRefPoseComponentSpaceTransforms(*SkeletalMesh, ComponentSpaceRefPose);
+							TEST_EQUAL_THROW(ComponentSpaceRefPose.Num(), RefPoseData->ComponentSpaceRefPose.Num());
+
+							TEST_TRUE_THROW(RefPoseData->PhysicsAsset == SkeletalMesh->PhysicsAsset);
+							TEST_TRUE_THROW(RefPoseData->CollisionBounds.IsValid);
+							TEST_TRUE_THROW(USkeletalMeshRefPoseData::GetCollisionBounds(*SkeletalMesh, *SkeletalMesh->PhysicsAsset) == RefPoseData->CollisionBounds);
+							TEST_EQUAL_TOLERANCE_THROW(RefPoseData->CollisionBounds.GetExtent().Z, Variant.GetCubeHalfZExtent(), 0.5f);
+						}
+						catch (...) {}
+					});
+			}
+
+			It("ignores data baked from another ref pose or other bone names", [this]()
+				{
+					try {
+						USkeletalMesh* SkeletalMesh = NewObject<USkeletalMesh>(GetTransientPackage());
+						TEST_NOT_NULL_THROW(SkeletalMesh);
+						SetTwoBoneRefSkeleton(*SkeletalMesh, TEXT("Bone1"), FVector{ 0, 0, 100.f });
+						const USkeletalMeshRefPoseData* RefPoseData = USkeletalMeshRefPoseData::Bake(*SkeletalMesh);
+						TEST_NOT_NULL_THROW(RefPoseData);
+						TEST_TRUE_THROW(USkeletalMeshRefPoseData::Find(*SkeletalMesh) == RefPoseData);
+
+						SetTwoBoneRefSkeleton(*SkeletalMesh, TEXT("Bone1"), FVector{ 0, 0, 200.f });
+						TEST_TRUE_THROW(USkeletalMeshRefPoseData::Find(*SkeletalMesh) == nullptr);
+						TEST_TRUE_THROW(USkeletalMeshRefPoseData::Bake(*SkeletalMesh) == RefPoseData);
+						TEST_TRUE_THROW(USkeletalMeshRefPoseData::Find(*SkeletalMesh) == RefPoseData);
+
+						SetTwoBoneRefSkeleton(*SkeletalMesh, TEXT("Bone2"), FVector{ 0, 0, 200.f });
+						TEST_TRUE_THROW(USkeletalMeshRefPoseData::Find(*SkeletalMesh) == nullptr);
+					}
+					catch (...) {}
+				});
+		});
+}
@@ -0,0 +1,107 @@
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+BEGIN_DEFINE_SPEC(FSkeletalMeshSweepLODSpec, "ComponentCollision.SweepLOD", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+END_DEFINE_COMPONENT_COLLISION_SPEC(FSkeletalMeshSweepLODSpec)
+
+void FSkeletalMeshSweepLODSpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("SweepLOD")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("USkeletalMeshSweepSubsystem::ComponentSweepMulti with a collision LOD proxy", [this]()
+		{
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("USkeletalMeshComponent (%s) proxy Sweep hits the floor like the full physics asset"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+							TEST_NOT_NULL_THROW(FloorPlaneCollider);
+							auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+							TEST_NOT_NULL_THROW(Subsystem);
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(Component);
+
+							FComponentQueryParams Params;
+							Params.AddIgnoredActor(Component->GetOwner());
+							TArray<FHitResult> FullHits;
+							TArray<FHitResult> ProxyHits;
+							Subsystem->SetCollisionLODOrigin(FVector::ZeroVector);
+							Fixture.BeginSweeps();
+							TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(FullHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, MAX_flt));
+							TEST_FALSE_THROW(Subsystem->GetLastSweepStats().bProxy);
+							TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(ProxyHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, 0.f));
+							TEST_TRUE_THROW(Subsystem->GetLastSweepStats().bProxy);
+							TEST_EQUAL_THROW(Subsystem->GetLastSweepStats().NumShapes, 1);
+
+							TEST_TRUE_THROW(ProxyHits.Last().GetComponent() == FloorPlaneCollider);
+							TEST_EQUAL_TOLERANCE_THROW(ProxyHits.Last().Distance, FullHits.Last().Distance, 0.5f);
+							TEST_EQUAL_TOLERANCE_THROW(ProxyHits.Last().Location, FullHits.Last().Location, 0.5f);
+							TEST_EQUAL_TOLERANCE_THROW(ProxyHits.Last().ImpactPoint.Z, FullHits.Last().ImpactPoint.Z, 0.5f);
+						}
+						catch (...) {}
+					});
+			}
+
+			It("picks the proxy by the distance of the sweep start from the LOD origin, per channel or per query", [this]()
+				{
+					try {
+						const float ProxyDistance = 5000.f;
+						const FVector NearSweepStart = FVector{ 0, 0, 1000.f };
+						const FVector FarSweepStart = FVector{ 0, 0, ProxyDistance + 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						TEST_NOT_NULL_THROW(Fixture.GetFloor());
+						auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[3]);
+						TEST_NOT_NULL_THROW(Component);
+						const ECollisionChannel Channel = Component->GetCollisionObjectType();
+
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Component->GetOwner());
+						TArray<FHitResult> OutHits;
+						Fixture.BeginSweeps();
+
+						// Without an origin nothing is far
+						Subsystem->ClearCollisionLODOrigin();
+						Subsystem->SetProxyDistance(Channel, ProxyDistance);
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, FarSweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_FALSE_THROW(Subsystem->GetLastSweepStats().bProxy);
+
+						Subsystem->SetCollisionLODOrigin(FVector::ZeroVector);
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, NearSweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_FALSE_THROW(Subsystem->GetLastSweepStats().bProxy);
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, FarSweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_TRUE_THROW(Subsystem->GetLastSweepStats().bProxy);
+
+						// A distance given with the query takes precedence over that of the channel
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, NearSweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, 500.f));
+						TEST_TRUE_THROW(Subsystem->GetLastSweepStats().bProxy);
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, FarSweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, MAX_flt));
+						TEST_FALSE_THROW(Subsystem->GetLastSweepStats().bProxy);
+
+						Subsystem->SetProxyDistance(Channel, -1.f);
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, FarSweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						TEST_FALSE_THROW(Subsystem->GetLastSweepStats().bProxy);
+					}
+					catch (...) {}
+				});
+		});
+}
@@ -0,0 +1,282 @@
+#include "ComponentCollisionSpecRegistry.h"
+#include "ComponentCollisionTestFixture.h"
+#include "ComponentCollisionTestHelpers.h"
+#include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "SkeletalMeshSweepSubsystem.h"
+#include "SweepCapture.h"
+
+namespace
+{
+	FString GetSweepCapturePath(const FString& Name)
+	{
+		return FPaths::ProjectSavedDir() / TEXT("Automation/SweepCaptures") / Name + TEXT(".sweepcap");
+	}
+
+	int32 GetNumReplayPasses()
+	{
+		int32 NumPasses = 100;
+		FParse::Value(FCommandLine::Get(), TEXT("SweepReplayPasses="), NumPasses);
+		return FMath::Max(NumPasses, 1);
+	}
+}
+
+BEGIN_DEFINE_SPEC(FSweepCaptureReplaySpec, "ComponentCollision.Replay", EAutomationTestFlags::ProductFilter | EAutomationTestFlags::EditorContext)
+	FComponentCollisionTestFixture Fixture;
+
+	void SaveAndReplay(const FString& Name, const FSweepCaptureWriter& Writer);
+	void Replay(const FString& Path);
+END_DEFINE_COMPONENT_COLLISION_SPEC(FSweepCaptureReplaySpec)
+
+void FSweepCaptureReplaySpec::SaveAndReplay(const FString& Name, const FSweepCaptureWriter& Writer)
+{
+	TEST_TRUE_THROW(Writer.GetNumQueries() > 0);
+	const FString Path = GetSweepCapturePath(Name);
+	TEST_TRUE_THROW(Writer.SaveToFile(Path));
+	Replay(Path);
+}
+
+void FSweepCaptureReplaySpec::Replay(const FString& Path)
+{
+	FSweepCaptureReader Capture;
+	TEST_TRUE_THROW(Capture.Open(Path));
+
+	// Replay in a new map that holds nothing but what the capture recorded
+	UWorld* World = CreateWorld();
+	TEST_NOT_NULL_THROW(World);
+	TArray<AActor*> Actors;
+	TEST_TRUE_THROW(FSweepCaptureReplay::SpawnActors(World, Capture, Actors));
+
+	Fixture.BeginSweeps();
+	const FSweepReplayResult Result = FSweepCaptureReplay::Run(World, Capture, Actors, GetNumReplayPasses());
+	AddInfo(FString::Printf(TEXT("%s: %d queries replayed in %.2f ms, %.0f queries/s, %d mismatches"),
+		*FPaths::GetBaseFilename(Path), Result.NumQueries, Result.QuerySeconds * 1000.0, Result.GetQueriesPerSecond(), Result.NumMismatches));
+	for (const FString& Mismatch : Result.Mismatches)
+		AddError(Mismatch);
+	TEST_EQUAL_THROW(Result.NumMismatches, 0);
+}
+
+void FSweepCaptureReplaySpec::Define()
+{
+	BeforeEach([this]() { Fixture.BeginTest(TEXT("Replay")); });
+	AfterEach([this]() { Fixture.EndTest(*this); });
+
+	Describe("Seed captures", [this]()
+		{
+			It("Sphere Sweep hits the floor from above", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+						TEST_NOT_NULL_THROW(FloorPlaneCollider);
+
+						FSweepCaptureWriter Writer;
+						Writer.AddActor(FloorPlaneCollider->GetOwner());
+						const FCollisionShape CollisionShape = FCollisionShape::MakeSphere(100.f);
+						const FCollisionQueryParams Params;
+						TArray<FHitResult> OutHits;
+						TEST_TRUE_THROW(World->SweepMultiByChannel(OutHits, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), ECollisionChannel::ECC_Visibility, CollisionShape, Params));
+						Writer.RecordShapeSweep(CollisionShape, ECollisionChannel::ECC_Visibility, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, OutHits);
+
+						SaveAndReplay(TEXT("SphereShape"), Writer);
+					}
+					catch (...) {}
+				});
+
+			It("USphereComponent Sweep hits the floor from above", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						USphereComponent* Component = CreatePrimitiveCollider<USphereComponent>(World);
+						TEST_NOT_NULL_THROW(Component);
+						Component->SetSphereRadius(100.f);
+
+						FSweepCaptureWriter Writer;
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Component->GetOwner());
+						TArray<FHitResult> OutHits;
+						TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						Writer.RecordComponentSweep(Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, OutHits);
+
+						SaveAndReplay(TEXT("USphereComponent"), Writer);
+					}
+					catch (...) {}
+				});
+
+			for (const FRefPoseCubeVariant& Variant : RefPoseCubeVariants)
+			{
+				It(FString::Printf(TEXT("USkeletalMeshComponent (%s) Sweep hits the floor from above"), Variant.Name), [this, Variant]()
+					{
+						try {
+							const FVector SweepStart = FVector{ 0, 0, 1000.f };
+							const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+							UWorld* World = Fixture.GetWorld();
+							TEST_NOT_NULL_THROW(World);
+							USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(Variant);
+							TEST_NOT_NULL_THROW(Component);
+
+							FSweepCaptureWriter Writer;
+							FComponentQueryParams Params;
+							Params.AddIgnoredActor(Component->GetOwner());
+							TArray<FHitResult> OutHits;
+							TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+							Writer.RecordComponentSweep(Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, OutHits);
+
+							SaveAndReplay(Variant.Name, Writer);
+						}
+						catch (...) {}
+					});
+			}
+
+			It("Floor hits UBoxCollider pair from above and from below", [this]()
+				{
+					try {
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+						TEST_NOT_NULL_THROW(FloorPlaneCollider);
+
+						auto ActorClass = Fixture.LoadActorClass<AActor>(TEXT("Blueprint'/Game/ComponentCollision/CubePair-UBoxColliders/BP_CubePair-UBoxColliders.BP_CubePair-UBoxColliders_C'"));
+						TEST_NOT_NULL_THROW(ActorClass);
+						auto Actor = World->SpawnActor<AActor>(ActorClass);
+						TEST_NOT_NULL_THROW(Actor);
+
+						FSweepCaptureWriter Writer;
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(FloorPlaneCollider->GetOwner());
+						TArray<FHitResult> OutHits;
+						for (const float SweepStartZ : { 1000.f, -1000.f })
+						{
+							const FVector SweepStart = FVector{ 0, 0, SweepStartZ };
+							const FVector SweepEnd = FVector{ 0, 0, -SweepStartZ };
+							TEST_TRUE_THROW(World->ComponentSweepMulti(OutHits, FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+							Writer.RecordComponentSweep(FloorPlaneCollider, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, OutHits);
+						}
+
+						SaveAndReplay(TEXT("CubePair-UBoxColliders"), Writer);
+					}
+					catch (...) {}
+				});
+		});
+
+	Describe("USkeletalMeshSweepSubsystem sweep capture", [this]()
+		{
+			It("records the sweeps made through the subsystem, with and without the proxy, and replays them through it", [this]()
+				{
+					try {
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						auto Subsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+						TEST_NOT_NULL_THROW(Subsystem);
+						USkeletalMeshComponent* Component = Fixture.SpawnRefPoseCube(RefPoseCubeVariants[3]);
+						TEST_NOT_NULL_THROW(Component);
+
+						FComponentQueryParams Params;
+						Params.AddIgnoredActor(Component->GetOwner());
+						TArray<FHitResult> OutHits;
+						Subsystem->BeginSweepCapture();
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params));
+						Subsystem->SetCollisionLODOrigin(FVector::ZeroVector);
+						TEST_TRUE_THROW(Subsystem->ComponentSweepMulti(OutHits, Component, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), Params, 0.f));
+						Subsystem->ClearCollisionLODOrigin();
+						TEST_TRUE_THROW(Subsystem->GetLastSweepStats().bProxy);
+						TEST_NOT_NULL_THROW(Subsystem->GetSweepCapture());
+						TEST_EQUAL_THROW(Subsystem->GetSweepCapture()->GetNumQueries(), 2);
+
+						const FString Path = GetSweepCapturePath(TEXT("SkeletalMeshSweepSubsystem"));
+						TEST_TRUE_THROW(Subsystem->EndSweepCapture(Path));
+						TEST_TRUE_THROW(Subsystem->GetSweepCapture() == nullptr);
+
+						FSweepCaptureReader Capture;
+						TEST_TRUE_THROW(Capture.Open(Path));
+						TEST_EQUAL_THROW(Capture.GetQueries().Num(), 2);
+						TEST_TRUE_THROW(Capture.GetQueries()[0].Flags == (ESweepCaptureQueryFlags::IgnoreSweptActor | ESweepCaptureQueryFlags::SkeletalMeshSweepSubsystem));
+						TEST_TRUE_THROW(Capture.GetQueries()[1].Flags == (ESweepCaptureQueryFlags::IgnoreSweptActor | ESweepCaptureQueryFlags::SkeletalMeshSweepSubsystem | ESweepCaptureQueryFlags::CollisionProxy));
+						Capture.Close();
+						Replay(Path);
+					}
+					catch (...) {}
+				});
+		});
+
+	Describe("FSweepCaptureReader::Open", [this]()
+		{
+			It("rejects captures with out of range hits or unterminated names", [this]()
+				{
+					try {
+						UWorld* World = Fixture.GetWorld();
+						TEST_NOT_NULL_THROW(World);
+						UBoxComponent* FloorPlaneCollider = Fixture.GetFloor();
+						TEST_NOT_NULL_THROW(FloorPlaneCollider);
+
+						const FVector SweepStart = FVector{ 0, 0, 1000.f };
+						const FVector SweepEnd = FVector{ 0, 0, -1000.f };
+						FSweepCaptureWriter Writer;
+						Writer.AddActor(FloorPlaneCollider->GetOwner());
+						const FCollisionShape CollisionShape = FCollisionShape::MakeSphere(100.f);
+						TArray<FHitResult> OutHits;
+						TEST_TRUE_THROW(World->SweepMultiByChannel(OutHits, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), ECollisionChannel::ECC_Visibility, CollisionShape, FCollisionQueryParams()));
+						Writer.RecordShapeSweep(CollisionShape, ECollisionChannel::ECC_Visibility, SweepStart, SweepEnd, FQuat(EForceInit::ForceInit), FCollisionQueryParams(), OutHits);
+
+						const FString Path = GetSweepCapturePath(TEXT("Corrupt"));
+						TEST_TRUE_THROW(Writer.SaveToFile(Path));
+						TArray<uint8> Bytes;
+						TEST_TRUE_THROW(FFileHelper::LoadFileToArray(Bytes, *Path));
+						const FSweepCaptureHeader Header = *reinterpret_cast<const FSweepCaptureHeader*>(Bytes.GetData());
+						TEST_EQUAL_THROW(Header.NumQueries, 1);
+
+						FSweepCaptureReader Capture;
+						TEST_TRUE_THROW(Capture.Open(Path));
+						Capture.Close();
+
+						const int32 QueryOffset = sizeof(FSweepCaptureHeader) + Header.NumActors * sizeof(FSweepCaptureActor) + Header.NumColliders * sizeof(FSweepCaptureCollider);
+						TArray<uint8> CorruptBytes = Bytes;
+						reinterpret_cast<FSweepCaptureQuery*>(CorruptBytes.GetData() + QueryOffset)->NumHits = Header.NumHits + 1;
+						TEST_TRUE_THROW(FFileHelper::SaveArrayToFile(CorruptBytes, *Path));
+						TEST_FALSE_THROW(Capture.Open(Path));
+
+						CorruptBytes = Bytes;
+						CorruptBytes.Last() = 'x';
+						TEST_TRUE_THROW(FFileHelper::SaveArrayToFile(CorruptBytes, *Path));
+						TEST_FALSE_THROW(Capture.Open(Path));
+					}
+					catch (...) {}
+				});
+		});
+
+	Describe("Production captures", [this]()
+		{
+			It("replays the capture given with -SweepCapture=", [this]()
+				{
+					try {
+						FString Path;
+						if (!FParse::Value(FCommandLine::Get(), TEXT("SweepCapture="), Path))
+						{
+							AddInfo(TEXT("No -SweepCapture= given, nothing to replay"));
+							return;
+						}
+						Replay(Path);
+					}
+					catch (...) {}
+				});
+		});
+}
@@ -0,0 +1,494 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SweepCapture.h"
+
+#include "Async/MappedFileHandle.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "SkeletalMeshSweepSubsystem.h"
+
+static_assert(sizeof(FSweepCaptureTransform) == 40, "Capture records must not change layout");
+static_assert(sizeof(FSweepCaptureHeader) == 32, "Capture records must not change layout");
+static_assert(sizeof(FSweepCaptureActor) == 52, "Capture records must not change layout");
+static_assert(sizeof(FSweepCaptureCollider) == 64, "Capture records must not change layout");
+static_assert(sizeof(FSweepCaptureQuery) == 72, "Capture records must not change layout");
+static_assert(sizeof(FSweepCaptureHit) == 40, "Capture records must not change layout");
+
+namespace
+{
+	const int32 MaxReportedMismatches = 16;
+
+	void StoreQuat(const FQuat& Quat, float (&OutRotation)[4])
+	{
+		OutRotation[0] = Quat.X;
+		OutRotation[1] = Quat.Y;
+		OutRotation[2] = Quat.Z;
+		OutRotation[3] = Quat.W;
+	}
+
+	FQuat LoadQuat(const float (&Rotation)[4])
+	{
+		return FQuat(Rotation[0], Rotation[1], Rotation[2], Rotation[3]);
+	}
+
+	/** Runtime colliders are the shape components that neither the actor class nor its construction script created. */
+	bool IsRuntimeCollider(const UActorComponent* Component)
+	{
+		return Component->IsA<UShapeComponent>()
+			&& !Component->IsDefaultSubobject()
+			&& Component->CreationMethod != EComponentCreationMethod::SimpleConstructionScript
+			&& Component->CreationMethod != EComponentCreationMethod::UserConstructionScript;
+	}
+
+	FVector GetUnscaledShapeExtent(const UShapeComponent* Component)
+	{
+		if (const UBoxComponent* Box = Cast<UBoxComponent>(Component))
+			return Box->GetUnscaledBoxExtent();
+		if (const USphereComponent* Sphere = Cast<USphereComponent>(Component))
+			return FVector(Sphere->GetUnscaledSphereRadius());
+		if (const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(Component))
+			return FVector(Capsule->GetUnscaledCapsuleRadius(), Capsule->GetUnscaledCapsuleRadius(), Capsule->GetUnscaledCapsuleHalfHeight());
+		return FVector::ZeroVector;
+	}
+
+	void SetUnscaledShapeExtent(UShapeComponent* Component, const FVector& Extent)
+	{
+		if (UBoxComponent* Box = Cast<UBoxComponent>(Component))
+			Box->SetBoxExtent(Extent);
+		else if (USphereComponent* Sphere = Cast<USphereComponent>(Component))
+			Sphere->SetSphereRadius(Extent.X);
+		else if (UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(Component))
+			Capsule->SetCapsuleSize(Extent.X, Extent.Z);
+	}
+
+	UPrimitiveComponent* FindComponentByName(AActor* Actor, FName ComponentName)
+	{
+		if (!Actor)
+			return nullptr;
+
+		for (UActorComponent* Component : Actor->GetComponents())
+			if (Component && Component->GetFName() == ComponentName)
+				return Cast<UPrimitiveComponent>(Component);
+		return nullptr;
+	}
+
+	template <typename RecordType>
+	void AppendRecords(TArray<uint8>& Bytes, const TArray<RecordType>& Records)
+	{
+		Bytes.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(RecordType));
+	}
+
+	bool IsValidRange(int32 First, int32 Num, int32 NumRecords)
+	{
+		return First >= 0 && Num >= 0 && static_cast<int64>(First) + Num <= NumRecords;
+	}
+
+	template <typename RecordType>
+	TArrayView<const RecordType> ViewRecords(const uint8*& Cursor, int32 Num)
+	{
+		TArrayView<const RecordType> Records(reinterpret_cast<const RecordType*>(Cursor), Num);
+		Cursor += Num * sizeof(RecordType);
+		return Records;
+	}
+}
+
+FSweepCaptureTransform FSweepCaptureTransform::Make(const FTransform& Transform)
+{
+	FSweepCaptureTransform Result;
+	Result.Location = Transform.GetLocation();
+	StoreQuat(Transform.GetRotation(), Result.Rotation);
+	Result.Scale = Transform.GetScale3D();
+	return Result;
+}
+
+FTransform FSweepCaptureTransform::ToTransform() const
+{
+	return FTransform(LoadQuat(Rotation), Location, Scale);
+}
+
+FCollisionShape FSweepCaptureQuery::MakeShape() const
+{
+	switch (ShapeType)
+	{
+	case ECollisionShape::Box:
+		return FCollisionShape::MakeBox(ShapeExtent);
+	case ECollisionShape::Sphere:
+		return FCollisionShape::MakeSphere(ShapeExtent.X);
+	case ECollisionShape::Capsule:
+		return FCollisionShape::MakeCapsule(ShapeExtent.X, ShapeExtent.Z);
+	default:
+		return FCollisionShape();
+	}
+}
+
+int32 FSweepCaptureWriter::AddActor(const AActor* Actor)
+{
+	if (!Actor)
+		return INDEX_NONE;
+
+	if (const int32* ExistingIndex = ActorIndices.Find(Actor))
+		return *ExistingIndex;
+
+	FSweepCaptureActor Record;
+	Record.ClassPathName = AddName(Actor->GetClass()->GetPathName());
+	Record.Transform = FSweepCaptureTransform::Make(Actor->GetActorTransform());
+	Record.FirstCollider = Colliders.Num();
+
+	for (const UActorComponent* Component : Actor->GetComponents())
+	{
+		if (!Component || !IsRuntimeCollider(Component))
+			continue;
+
+		const UShapeComponent* ShapeComponent = CastChecked<UShapeComponent>(Component);
+		FSweepCaptureCollider& Collider = Colliders.AddDefaulted_GetRef();
+		Collider.ComponentName = AddName(ShapeComponent->GetName());
+		Collider.ClassPathName = AddName(ShapeComponent->GetClass()->GetPathName());
+		Collider.ProfileName = AddName(ShapeComponent->GetCollisionProfileName().ToString());
+		Collider.Transform = FSweepCaptureTransform::Make(ShapeComponent->GetComponentTransform());
+		Collider.ShapeExtent = GetUnscaledShapeExtent(ShapeComponent);
+	}
+	Record.NumColliders = Colliders.Num() - Record.FirstCollider;
+
+	ActorIndices.Add(Actor, Actors.Num());
+	return Actors.Add(Record);
+}
+
+void FSweepCaptureWriter::RecordComponentSweep(const UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, TArrayView<const FHitResult> InHits)
+{
+	if (!Component || !Component->GetOwner())
+		return;
+
+	FSweepCaptureQuery& Query = AddQuery(Start, End, Rot, Params, InHits);
+	Query.Actor = AddActor(Component->GetOwner());
+	Query.ComponentName = AddName(Component->GetName());
+	Query.Channel = Component->GetCollisionObjectType();
+	if (Params.GetIgnoredActors().Contains(Component->GetOwner()->GetUniqueID()))
+		Query.Flags |= ESweepCaptureQueryFlags::IgnoreSweptActor;
+}
+
+void FSweepCaptureWriter::RecordSubsystemSweep(const USkeletalMeshComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, bool bProxy, TArrayView<const FHitResult> InHits)
+{
+	const int32 NumQueriesBefore = Queries.Num();
+	RecordComponentSweep(Component, Start, End, Rot, Params, InHits);
+	if (Queries.Num() == NumQueriesBefore)
+		return;
+
+	Queries.Last().Flags |= ESweepCaptureQueryFlags::SkeletalMeshSweepSubsystem;
+	if (bProxy)
+		Queries.Last().Flags |= ESweepCaptureQueryFlags::CollisionProxy;
+}
+
+void FSweepCaptureWriter::RecordShapeSweep(const FCollisionShape& Shape, ECollisionChannel TraceChannel, const FVector& Start, const FVector& End, const FQuat& Rot, const FCollisionQueryParams& Params, TArrayView<const FHitResult> InHits)
+{
+	FSweepCaptureQuery& Query = AddQuery(Start, End, Rot, Params, InHits);
+	Query.ShapeType = Shape.ShapeType;
+	Query.ShapeExtent = Shape.GetExtent();
+	Query.Channel = TraceChannel;
+}
+
+bool FSweepCaptureWriter::SaveToFile(const FString& Path) const
+{
+	TArray<int32> NameOffsets;
+	TArray<ANSICHAR> NameBytes;
+	for (const FString& Name : Names)
+	{
+		NameOffsets.Add(NameBytes.Num());
+		FTCHARToUTF8 Utf8Name(*Name);
+		NameBytes.Append(Utf8Name.Get(), Utf8Name.Length());
+		NameBytes.Add('\0');
+	}
+	// Pad to the 4 byte alignment of the records
+	while (NameBytes.Num() % 4 != 0)
+		NameBytes.Add('\0');
+
+	FSweepCaptureHeader Header;
+	Header.Magic = FSweepCaptureHeader::ExpectedMagic;
+	Header.Version = FSweepCaptureHeader::CurrentVersion;
+	Header.NumActors = Actors.Num();
+	Header.NumColliders = Colliders.Num();
+	Header.NumQueries = Queries.Num();
+	Header.NumHits = Hits.Num();
+	Header.NumNames = Names.Num();
+	Header.NameBytes = NameBytes.Num();
+
+	TArray<uint8> Bytes;
+	Bytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	AppendRecords(Bytes, Actors);
+	AppendRecords(Bytes, Colliders);
+	AppendRecords(Bytes, Queries);
+	AppendRecords(Bytes, Hits);
+	AppendRecords(Bytes, NameOffsets);
+	AppendRecords(Bytes, NameBytes);
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+int32 FSweepCaptureWriter::AddName(const FString& Name)
+{
+	if (const int32* ExistingIndex = NameIndices.Find(Name))
+		return *ExistingIndex;
+
+	NameIndices.Add(Name, Names.Num());
+	return Names.Add(Name);
+}
+
+FSweepCaptureQuery& FSweepCaptureWriter::AddQuery(const FVector& Start, const FVector& End, const FQuat& Rot, const FCollisionQueryParams& Params, TArrayView<const FHitResult> InHits)
+{
+	FSweepCaptureQuery& Query = Queries.AddZeroed_GetRef();
+	Query.Actor = INDEX_NONE;
+	Query.ComponentName = INDEX_NONE;
+	Query.ShapeType = ECollisionShape::Line;
+	Query.Flags = Params.bTraceComplex ? ESweepCaptureQueryFlags::TraceComplex : ESweepCaptureQueryFlags::None;
+	Query.Start = Start;
+	Query.End = End;
+	StoreQuat(Rot, Query.Rotation);
+	Query.FirstHit = Hits.Num();
+	Query.NumHits = InHits.Num();
+
+	for (const FHitResult& InHit : InHits)
+	{
+		FSweepCaptureHit& Hit = Hits.AddZeroed_GetRef();
+		const UPrimitiveComponent* HitComponent = InHit.GetComponent();
+		Hit.Actor = HitComponent ? AddActor(HitComponent->GetOwner()) : INDEX_NONE;
+		Hit.ComponentName = HitComponent ? AddName(HitComponent->GetName()) : INDEX_NONE;
+		Hit.Time = InHit.Time;
+		Hit.ImpactPoint = InHit.ImpactPoint;
+		Hit.ImpactNormal = InHit.ImpactNormal;
+		Hit.bBlockingHit = InHit.bBlockingHit;
+		Hit.bStartPenetrating = InHit.bStartPenetrating;
+	}
+
+	// AddActor may have added records, but not queries, so the reference is still valid
+	return Query;
+}
+
+FSweepCaptureReader::FSweepCaptureReader() = default;
+FSweepCaptureReader::~FSweepCaptureReader() = default;
+
+void FSweepCaptureReader::Close()
+{
+	Actors = {};
+	Colliders = {};
+	Queries = {};
+	Hits = {};
+	NameOffsets = {};
+	NameBytes = {};
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+bool FSweepCaptureReader::Open(const FString& Path)
+{
+	Close();
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FSweepCaptureHeader)))
+		return false;
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize(), true));
+	if (!MappedRegion.IsValid())
+		return false;
+
+	const uint8* Cursor = MappedRegion->GetMappedPtr();
+	const FSweepCaptureHeader& Header = *reinterpret_cast<const FSweepCaptureHeader*>(Cursor);
+	if (Header.Magic != FSweepCaptureHeader::ExpectedMagic || Header.Version != FSweepCaptureHeader::CurrentVersion)
+		return false;
+
+	if (Header.NumActors < 0 || Header.NumColliders < 0 || Header.NumQueries < 0 || Header.NumHits < 0 || Header.NumNames < 0 || Header.NameBytes < 0)
+		return false;
+
+	const int64 ExpectedSize = sizeof(FSweepCaptureHeader)
+		+ static_cast<int64>(Header.NumActors) * sizeof(FSweepCaptureActor)
+		+ static_cast<int64>(Header.NumColliders) * sizeof(FSweepCaptureCollider)
+		+ static_cast<int64>(Header.NumQueries) * sizeof(FSweepCaptureQuery)
+		+ static_cast<int64>(Header.NumHits) * sizeof(FSweepCaptureHit)
+		+ static_cast<int64>(Header.NumNames) * sizeof(int32)
+		+ Header.NameBytes;
+	if (ExpectedSize != MappedRegion->GetMappedSize())
+		return false;
+
+	Cursor += sizeof(FSweepCaptureHeader);
+	Actors = ViewRecords<FSweepCaptureActor>(Cursor, Header.NumActors);
+	Colliders = ViewRecords<FSweepCaptureCollider>(Cursor, Header.NumColliders);
+	Queries = ViewRecords<FSweepCaptureQuery>(Cursor, Header.NumQueries);
+	Hits = ViewRecords<FSweepCaptureHit>(Cursor, Header.NumHits);
+	NameOffsets = ViewRecords<int32>(Cursor, Header.NumNames);
+	NameBytes = ViewRecords<ANSICHAR>(Cursor, Header.NameBytes);
+
+	// Replay slices the records by these ranges, so a truncated or corrupt capture must be rejected here
+	bool bValid = true;
+	for (const FSweepCaptureActor& Actor : Actors)
+		bValid &= IsValidRange(Actor.FirstCollider, Actor.NumColliders, Colliders.Num());
+	for (const FSweepCaptureQuery& Query : Queries)
+	{
+		bValid &= IsValidRange(Query.FirstHit, Query.NumHits, Hits.Num());
+		bValid &= Query.IsComponentSweep() || !EnumHasAnyFlags(Query.Flags, ESweepCaptureQueryFlags::SkeletalMeshSweepSubsystem);
+	}
+	for (const int32 NameOffset : NameOffsets)
+		bValid &= NameBytes.IsValidIndex(NameOffset);
+	// Every name then ends at a NUL before the end of the name bytes
+	bValid &= NameOffsets.Num() == 0 || NameBytes.Last() == '\0';
+
+	if (!bValid)
+		Close();
+	return bValid;
+}
+
+FString FSweepCaptureReader::GetName(int32 NameIndex) const
+{
+	if (!NameOffsets.IsValidIndex(NameIndex) || !NameBytes.IsValidIndex(NameOffsets[NameIndex]))
+		return FString();
+	return FString(UTF8_TO_TCHAR(NameBytes.GetData() + NameOffsets[NameIndex]));
+}
+
+bool FSweepCaptureReplay::SpawnActors(UWorld* World, const FSweepCaptureReader& Capture, TArray<AActor*>& OutActors)
+{
+	OutActors.Reset();
+	if (!World)
+		return false;
+
+	bool bAllSpawned = true;
+	for (const FSweepCaptureActor& Record : Capture.GetActors())
+	{
+		UClass* ActorClass = LoadClass<AActor>(nullptr, *Capture.GetName(Record.ClassPathName));
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		const FTransform ActorTransform = Record.Transform.ToTransform();
+		AActor* Actor = ActorClass ? World->SpawnActor<AActor>(ActorClass, ActorTransform, SpawnParams) : nullptr;
+		OutActors.Add(Actor);
+		if (!Actor)
+		{
+			bAllSpawned = false;
+			continue;
+		}
+
+		for (const FSweepCaptureCollider& Collider : Capture.GetColliders().Slice(Record.FirstCollider, Record.NumColliders))
+		{
+			UClass* ColliderClass = LoadClass<UShapeComponent>(nullptr, *Capture.GetName(Collider.ClassPathName));
+			UShapeComponent* Component = ColliderClass ? NewObject<UShapeComponent>(Actor, ColliderClass, *Capture.GetName(Collider.ComponentName)) : nullptr;
+			if (!Component)
+			{
+				bAllSpawned = false;
+				continue;
+			}
+
+			Component->RegisterComponent();
+			Component->SetWorldTransform(Collider.Transform.ToTransform());
+			SetUnscaledShapeExtent(Component, Collider.ShapeExtent);
+			Component->SetCollisionProfileName(*Capture.GetName(Collider.ProfileName));
+		}
+	}
+
+	return bAllSpawned;
+}
+
+FSweepReplayResult FSweepCaptureReplay::Run(UWorld* World, const FSweepCaptureReader& Capture, TArrayView<AActor* const> Actors, int32 NumPasses, float Tolerance)
+{
+	FSweepReplayResult Result;
+	if (!World)
+		return Result;
+
+	auto ReportMismatch = [&Result](int32 QueryIndex, const FString& Description)
+	{
+		Result.NumMismatches++;
+		if (Result.Mismatches.Num() < MaxReportedMismatches)
+			Result.Mismatches.Add(FString::Printf(TEXT("Query %d: %s"), QueryIndex, *Description));
+	};
+
+	// Subsystem sweeps are replayed with a proxy distance that reproduces whether they used the proxy: 0 from any
+	// collision LOD origin, or never
+	USkeletalMeshSweepSubsystem* SweepSubsystem = World->GetSubsystem<USkeletalMeshSweepSubsystem>();
+	if (SweepSubsystem)
+		SweepSubsystem->SetCollisionLODOrigin(FVector::ZeroVector);
+
+	// Resolve every component up front so that the timed loop only runs queries
+	const TArrayView<const FSweepCaptureQuery> Queries = Capture.GetQueries();
+	TArray<UPrimitiveComponent*> SweptComponents;
+	TArray<FComponentQueryParams> QueryParams;
+	TArray<TArray<const UPrimitiveComponent*>> ExpectedHitComponents;
+	for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); QueryIndex++)
+	{
+		const FSweepCaptureQuery& Query = Queries[QueryIndex];
+		AActor* SweptActor = Query.IsComponentSweep() && Actors.IsValidIndex(Query.Actor) ? Actors[Query.Actor] : nullptr;
+		SweptComponents.Add(FindComponentByName(SweptActor, *Capture.GetName(Query.ComponentName)));
+		if (Query.IsComponentSweep() && !SweptComponents.Last())
+			ReportMismatch(QueryIndex, FString::Printf(TEXT("swept component %s not found"), *Capture.GetName(Query.ComponentName)));
+		else if (EnumHasAnyFlags(Query.Flags, ESweepCaptureQueryFlags::SkeletalMeshSweepSubsystem) && (!SweepSubsystem || !SweptComponents.Last()->IsA<USkeletalMeshComponent>()))
+		{
+			ReportMismatch(QueryIndex, FString::Printf(TEXT("swept component %s can't be swept through USkeletalMeshSweepSubsystem"), *Capture.GetName(Query.ComponentName)));
+			SweptComponents.Last() = nullptr;
+		}
+
+		FComponentQueryParams& Params = QueryParams.AddDefaulted_GetRef();
+		Params.bTraceComplex = EnumHasAnyFlags(Query.Flags, ESweepCaptureQueryFlags::TraceComplex);
+		if (SweptActor && EnumHasAnyFlags(Query.Flags, ESweepCaptureQueryFlags::IgnoreSweptActor))
+			Params.AddIgnoredActor(SweptActor);
+
+		TArray<const UPrimitiveComponent*>& HitComponents = ExpectedHitComponents.AddDefaulted_GetRef();
+		for (const FSweepCaptureHit& Hit : Capture.GetHits(Query))
+			HitComponents.Add(Actors.IsValidIndex(Hit.Actor) ? FindComponentByName(Actors[Hit.Actor], *Capture.GetName(Hit.ComponentName)) : nullptr);
+	}
+
+	TArray<FHitResult> OutHits;
+	uint64 QueryCycles = 0;
+	for (int32 Pass = 0; Pass < NumPasses; Pass++)
+	{
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); QueryIndex++)
+		{
+			const FSweepCaptureQuery& Query = Queries[QueryIndex];
+			if (Query.IsComponentSweep() && !SweptComponents[QueryIndex])
+				continue;
+
+			const FQuat Rot = LoadQuat(Query.Rotation);
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			if (EnumHasAnyFlags(Query.Flags, ESweepCaptureQueryFlags::SkeletalMeshSweepSubsystem))
+			{
+				const float ProxyDistance = EnumHasAnyFlags(Query.Flags, ESweepCaptureQueryFlags::CollisionProxy) ? 0.f : MAX_flt;
+				SweepSubsystem->ComponentSweepMulti(OutHits, CastChecked<USkeletalMeshComponent>(SweptComponents[QueryIndex]), Query.Start, Query.End, Rot, QueryParams[QueryIndex], ProxyDistance);
+			}
+			else if (Query.IsComponentSweep())
+				World->ComponentSweepMulti(OutHits, SweptComponents[QueryIndex], Query.Start, Query.End, Rot, QueryParams[QueryIndex]);
+			else
+				World->SweepMultiByChannel(OutHits, Query.Start, Query.End, Rot, static_cast<ECollisionChannel>(Query.Channel), Query.MakeShape(), QueryParams[QueryIndex]);
+			QueryCycles += FPlatformTime::Cycles64() - StartCycles;
+			Result.NumQueries++;
+
+			// Every pass runs the same queries against the same world, so only the first one is compared
+			if (Pass > 0)
+				continue;
+
+			const TArrayView<const FSweepCaptureHit> ExpectedHits = Capture.GetHits(Query);
+			if (OutHits.Num() != ExpectedHits.Num())
+			{
+				ReportMismatch(QueryIndex, FString::Printf(TEXT("%d hits, expected %d"), OutHits.Num(), ExpectedHits.Num()));
+				continue;
+			}
+
+			const float SweepLength = FVector::Dist(Query.Start, Query.End);
+			for (int32 HitIndex = 0; HitIndex < ExpectedHits.Num(); HitIndex++)
+			{
+				const FHitResult& Hit = OutHits[HitIndex];
+				const FSweepCaptureHit& ExpectedHit = ExpectedHits[HitIndex];
+				const UPrimitiveComponent* ExpectedComponent = ExpectedHitComponents[QueryIndex][HitIndex];
+				if (ExpectedComponent && Hit.GetComponent() != ExpectedComponent)
+					ReportMismatch(QueryIndex, FString::Printf(TEXT("hit %d is on %s, expected %s"), HitIndex, *GetNameSafe(Hit.GetComponent()), *Capture.GetName(ExpectedHit.ComponentName)));
+				else if (Hit.bBlockingHit != !!ExpectedHit.bBlockingHit || Hit.bStartPenetrating != !!ExpectedHit.bStartPenetrating)
+					ReportMismatch(QueryIndex, FString::Printf(TEXT("hit %d has different blocking or penetration flags"), HitIndex));
+				else if (FMath::Abs(Hit.Time - ExpectedHit.Time) * SweepLength > Tolerance || !Hit.ImpactPoint.Equals(ExpectedHit.ImpactPoint, Tolerance))
+					ReportMismatch(QueryIndex, FString::Printf(TEXT("hit %d at time %f and %s, expected %f and %s"), HitIndex, Hit.Time, *Hit.ImpactPoint.ToString(), ExpectedHit.Time, *ExpectedHit.ImpactPoint.ToString()));
+			}
+		}
+	}
+
+	if (SweepSubsystem)
+		SweepSubsystem->ClearCollisionLODOrigin();
+	Result.QuerySeconds = FPlatformTime::ToSeconds64(QueryCycles);
+	return Result;
+}
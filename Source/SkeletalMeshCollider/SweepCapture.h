@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "Engine/EngineTypes.h"
+#include "Templates/UniquePtr.h"
+
+class AActor;
+class IMappedFileHandle;
+class IMappedFileRegion;
+class UPrimitiveComponent;
+class USkeletalMeshComponent;
+class UWorld;
+
+/*
+ * Sweep capture file layout. Every record is plain data with 4 byte alignment, so a mapped file is used in place:
+ *
+ *   FSweepCaptureHeader
+ *   FSweepCaptureActor[NumActors]
+ *   FSweepCaptureCollider[NumColliders]
+ *   FSweepCaptureQuery[NumQueries]
+ *   FSweepCaptureHit[NumHits]
+ *   int32 NameOffsets[NumNames]
+ *   UTF-8 names, each terminated by a NUL, NameBytes in total
+ *
+ * Names are referenced by index: actor class paths, component names and collision profile names.
+ */
+
+struct FSweepCaptureTransform
+{
+	FVector Location;
+	float Rotation[4];
+	FVector Scale;
+
+	static FSweepCaptureTransform Make(const FTransform& Transform);
+	FTransform ToTransform() const;
+};
+
+struct FSweepCaptureHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x50435753; // "SWCP"
+	static constexpr uint32 CurrentVersion = 2;
+
+	uint32 Magic;
+	uint32 Version;
+	int32 NumActors;
+	int32 NumColliders;
+	int32 NumQueries;
+	int32 NumHits;
+	int32 NumNames;
+	int32 NameBytes;
+};
+
+/** Actor to spawn from its class before replaying, with the colliders that were added to it at runtime. */
+struct FSweepCaptureActor
+{
+	int32 ClassPathName;
+	FSweepCaptureTransform Transform;
+	int32 FirstCollider;
+	int32 NumColliders;
+};
+
+/** Box, sphere or capsule component created at runtime rather than by the actor class, like the test floor. */
+struct FSweepCaptureCollider
+{
+	int32 ComponentName;
+	int32 ClassPathName;
+	int32 ProfileName;
+	FSweepCaptureTransform Transform;
+	/** Unscaled box extent, (radius, radius, radius) for spheres and (radius, radius, half height) for capsules. */
+	FVector ShapeExtent;
+};
+
+enum class ESweepCaptureQueryFlags : uint8
+{
+	None = 0,
+	TraceComplex = 1 << 0,
+	/** The actor owning the swept component is ignored. */
+	IgnoreSweptActor = 1 << 1,
+	/** Made through USkeletalMeshSweepSubsystem::ComponentSweepMulti rather than UWorld::ComponentSweepMulti. */
+	SkeletalMeshSweepSubsystem = 1 << 2,
+	/** Made through USkeletalMeshSweepSubsystem, which swept the collision LOD proxy of the component. */
+	CollisionProxy = 1 << 3,
+};
+ENUM_CLASS_FLAGS(ESweepCaptureQueryFlags);
+
+/**
+ * ComponentSweepMulti when Actor is set, of USkeletalMeshSweepSubsystem or UWorld as Flags say, and
+ * SweepMultiByChannel with Shape otherwise.
+ */
+struct FSweepCaptureQuery
+{
+	int32 Actor;
+	int32 ComponentName;
+	uint8 ShapeType;
+	uint8 Channel;
+	ESweepCaptureQueryFlags Flags;
+	uint8 Padding;
+	FVector ShapeExtent;
+	FVector Start;
+	FVector End;
+	float Rotation[4];
+	int32 FirstHit;
+	int32 NumHits;
+
+	bool IsComponentSweep() const { return Actor != INDEX_NONE; }
+	FCollisionShape MakeShape() const;
+};
+
+struct FSweepCaptureHit
+{
+	/** INDEX_NONE when the hit component belongs to an actor that could not be captured. */
+	int32 Actor;
+	int32 ComponentName;
+	float Time;
+	FVector ImpactPoint;
+	FVector ImpactNormal;
+	uint8 bBlockingHit;
+	uint8 bStartPenetrating;
+	uint16 Padding;
+};
+
+/**
+ * Records sweep queries and their hits, together with the actors they reference, into the capture format.
+ *
+ * Actors are recorded by class path and transform, which is enough to rebuild them when their class is a
+ * blueprint or native class; only box, sphere and capsule components added at runtime are recorded on top of
+ * that. Welds, ignored components and ignored actors other than the owner of the swept component are not
+ * captured.
+ */
+class SKELETALMESHCOLLIDER_API FSweepCaptureWriter
+{
+public:
+	/** Records an actor so it is respawned on replay even if no query references it; returns its index. */
+	int32 AddActor(const AActor* Actor);
+
+	void RecordComponentSweep(const UPrimitiveComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, TArrayView<const FHitResult> Hits);
+	/** Records a sweep made through USkeletalMeshSweepSubsystem, so that it is replayed through it, with the proxy if bProxy. */
+	void RecordSubsystemSweep(const USkeletalMeshComponent* Component, const FVector& Start, const FVector& End, const FQuat& Rot, const FComponentQueryParams& Params, bool bProxy, TArrayView<const FHitResult> Hits);
+	void RecordShapeSweep(const FCollisionShape& Shape, ECollisionChannel TraceChannel, const FVector& Start, const FVector& End, const FQuat& Rot, const FCollisionQueryParams& Params, TArrayView<const FHitResult> Hits);
+
+	int32 GetNumQueries() const { return Queries.Num(); }
+
+	bool SaveToFile(const FString& Path) const;
+
+private:
+	int32 AddName(const FString& Name);
+	FSweepCaptureQuery& AddQuery(const FVector& Start, const FVector& End, const FQuat& Rot, const FCollisionQueryParams& Params, TArrayView<const FHitResult> Hits);
+
+	TArray<FSweepCaptureActor> Actors;
+	TMap<const AActor*, int32> ActorIndices;
+	TArray<FSweepCaptureCollider> Colliders;
+	TArray<FSweepCaptureQuery> Queries;
+	TArray<FSweepCaptureHit> Hits;
+	TArray<FString> Names;
+	TMap<FString, int32> NameIndices;
+};
+
+/** Read-only view of a capture file, memory mapped rather than loaded. */
+class SKELETALMESHCOLLIDER_API FSweepCaptureReader
+{
+public:
+	FSweepCaptureReader();
+	~FSweepCaptureReader();
+
+	/**
+	 * Maps the file and validates its header, sizes, record ranges and names; returns false if it is not a valid
+	 * capture of this version.
+	 */
+	bool Open(const FString& Path);
+	void Close();
+
+	TArrayView<const FSweepCaptureActor> GetActors() const { return Actors; }
+	TArrayView<const FSweepCaptureCollider> GetColliders() const { return Colliders; }
+	TArrayView<const FSweepCaptureQuery> GetQueries() const { return Queries; }
+	TArrayView<const FSweepCaptureHit> GetHits() const { return Hits; }
+	TArrayView<const FSweepCaptureHit> GetHits(const FSweepCaptureQuery& Query) const { return Hits.Slice(Query.FirstHit, Query.NumHits); }
+
+	/** Returns an empty string for INDEX_NONE. */
+	FString GetName(int32 NameIndex) const;
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	TArrayView<const FSweepCaptureActor> Actors;
+	TArrayView<const FSweepCaptureCollider> Colliders;
+	TArrayView<const FSweepCaptureQuery> Queries;
+	TArrayView<const FSweepCaptureHit> Hits;
+	TArrayView<const int32> NameOffsets;
+	TArrayView<const ANSICHAR> NameBytes;
+};
+
+struct SKELETALMESHCOLLIDER_API FSweepReplayResult
+{
+	int32 NumQueries = 0;
+	/** Swept components that could not be found, and hits that differ in the first pass; later passes are only timed. */
+	int32 NumMismatches = 0;
+	/** Time spent in the queries themselves, without spawning and hit comparison. */
+	double QuerySeconds = 0.0;
+	/** Descriptions of the first mismatches. */
+	TArray<FString> Mismatches;
+
+	double GetQueriesPerSecond() const { return QuerySeconds > 0.0 ? NumQueries / QuerySeconds : 0.0; }
+};
+
+class SKELETALMESHCOLLIDER_API FSweepCaptureReplay
+{
+public:
+	/** Spawns the actors and runtime colliders of the capture into World; OutActors is indexed like the capture. */
+	static bool SpawnActors(UWorld* World, const FSweepCaptureReader& Capture, TArray<AActor*>& OutActors);
+
+	/**
+	 * Runs every query of the capture NumPasses times against World, through USkeletalMeshSweepSubsystem for the
+	 * sweeps that were made through it, and compares the hits of the first pass with the recorded ones: same
+	 * number of hits, and for each hit the same component, the same blocking and penetration flags, and a distance
+	 * along the sweep and an impact point within Tolerance centimeters.
+	 */
+	static FSweepReplayResult Run(UWorld* World, const FSweepCaptureReader& Capture, TArrayView<AActor* const> Actors, int32 NumPasses = 1, float Tolerance = 0.1f);
+};
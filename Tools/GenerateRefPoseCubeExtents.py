@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Generates the collider extents of the ref pose cube skeletal meshes under Content/ComponentCollision.
+
+The extents the specs expect the cubes to collide with follow from how the FBX sources were authored: the mesh
+vertices in the bind pose of the mesh node. Rather than keeping them by hand next to the test code, this reads every
+Content/ComponentCollision/Cube-*/SK_*.fbx (binary FBX only, no SDK needed), converts the bind pose bounds to
+Unreal axes and units the way the importer does, and writes them to Content/ComponentCollision/RefPoseCubeExtents.json,
+which ComponentCollisionTestHelpers.h reads. Run it again whenever a cube source changes.
+
+    Tools/GenerateRefPoseCubeExtents.py [--check]
+"""
+
+import argparse
+import glob
+import json
+import os
+import struct
+import sys
+import zlib
+
+PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CONTENT_DIR = os.path.join(PROJECT_DIR, 'Content', 'ComponentCollision')
+OUTPUT_PATH = os.path.join(CONTENT_DIR, 'RefPoseCubeExtents.json')
+FBX_MAGIC = b'Kaydara FBX Binary  \x00'
+
+
+class Node:
+    def __init__(self, name, properties, children):
+        self.name = name
+        self.properties = properties
+        self.children = children
+
+    def find(self, name):
+        return next((child for child in self.children if child.name == name), None)
+
+    def find_all(self, name):
+        return [child for child in self.children if child.name == name]
+
+
+def read_property(data, offset):
+    type_code = chr(data[offset])
+    offset += 1
+    scalars = {'Y': '<h', 'C': '<?', 'I': '<i', 'F': '<f', 'D': '<d', 'L': '<q'}
+    arrays = {'f': 'f', 'd': 'd', 'l': 'q', 'i': 'i', 'b': '?'}
+    if type_code in scalars:
+        size = struct.calcsize(scalars[type_code])
+        return struct.unpack_from(scalars[type_code], data, offset)[0], offset + size
+    if type_code in arrays:
+        length, encoding, compressed_length = struct.unpack_from('<III', data, offset)
+        offset += 12
+        raw = data[offset:offset + compressed_length]
+        if encoding == 1:
+            raw = zlib.decompress(raw)
+        return list(struct.unpack('<%d%s' % (length, arrays[type_code]), raw)), offset + compressed_length
+    if type_code in 'SR':
+        length = struct.unpack_from('<I', data, offset)[0]
+        offset += 4
+        return bytes(data[offset:offset + length]), offset + length
+    raise ValueError('Unknown FBX property type %r' % type_code)
+
+
+def read_node(data, offset, wide):
+    header = '<QQQB' if wide else '<IIIB'
+    end_offset, num_properties, _, name_length = struct.unpack_from(header, data, offset)
+    offset += struct.calcsize(header)
+    if end_offset == 0:
+        return None, offset
+    name = data[offset:offset + name_length].decode('ascii')
+    offset += name_length
+    properties = []
+    for _ in range(num_properties):
+        value, offset = read_property(data, offset)
+        properties.append(value)
+    children = []
+    while offset < end_offset:
+        child, offset = read_node(data, offset, wide)
+        if child:
+            children.append(child)
+    return Node(name, properties, children), end_offset
+
+
+def read_fbx(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if not data.startswith(FBX_MAGIC):
+        sys.exit(path + ' is not a binary FBX file')
+    version = struct.unpack_from('<I', data, 23)[0]
+    wide = version >= 7500
+    offset = 27
+    nodes = []
+    while offset < len(data):
+        node, offset = read_node(data, offset, wide)
+        if not node:
+            break
+        nodes.append(node)
+    return Node('', [], nodes)
+
+
+def object_name(node):
+    return node.properties[1].split(b'\x00\x01')[0].decode('utf-8')
+
+
+def global_setting(root, name, default):
+    properties = root.find('GlobalSettings').find('Properties70')
+    for p in properties.find_all('P') if properties else []:
+        if p.properties[0] == name.encode('ascii'):
+            return p.properties[4]
+    return default
+
+
+def bind_pose_matrices(root):
+    matrices = {}
+    for pose in root.find('Objects').find_all('Pose'):
+        for pose_node in pose.find_all('PoseNode'):
+            matrices[pose_node.find('Node').properties[0]] = pose_node.find('Matrix').properties[0]
+    return matrices
+
+
+def mesh_half_extent(path):
+    root = read_fbx(path)
+    objects = root.find('Objects')
+    geometries = {node.properties[0]: node for node in objects.find_all('Geometry') if node.properties[2] == b'Mesh'}
+    models = {node.properties[0]: node for node in objects.find_all('Model') if node.properties[2] == b'Mesh'}
+    matrices = bind_pose_matrices(root)
+
+    geometry, model_id = None, None
+    for connection in root.find('Connections').find_all('C'):
+        if connection.properties[0] == b'OO' and connection.properties[1] in geometries and connection.properties[2] in models:
+            geometry, model_id = geometries[connection.properties[1]], connection.properties[2]
+            break
+    if geometry is None:
+        sys.exit('No mesh found in ' + path)
+    if model_id not in matrices:
+        sys.exit('No bind pose for mesh %s in %s' % (object_name(models[model_id]), path))
+
+    # FBX matrices are stored row-major for row vectors, with the translation in the last row
+    matrix = matrices[model_id]
+    vertices = geometry.find('Vertices').properties[0]
+    low, high = [float('inf')] * 3, [float('-inf')] * 3
+    for index in range(0, len(vertices), 3):
+        vertex = vertices[index:index + 3] + [1.0]
+        for axis in range(3):
+            value = sum(vertex[row] * matrix[row * 4 + axis] for row in range(4))
+            low[axis], high[axis] = min(low[axis], value), max(high[axis], value)
+
+    # The importer converts to Z up, X forward; the extents don't depend on the signs of the axes
+    unit_scale = global_setting(root, 'UnitScaleFactor', 1.0)
+    axes = [global_setting(root, 'CoordAxis', 0), global_setting(root, 'FrontAxis', 2), global_setting(root, 'UpAxis', 1)]
+    return [round((high[axis] - low[axis]) * 0.5 * unit_scale, 4) for axis in axes]
+
+
+def generate():
+    extents = {}
+    for path in sorted(glob.glob(os.path.join(CONTENT_DIR, 'Cube-*', 'SK_*.fbx'))):
+        variant = os.path.basename(os.path.dirname(path))
+        extents[variant] = {
+            'Source': os.path.relpath(path, CONTENT_DIR).replace(os.sep, '/'),
+            'HalfExtent': mesh_half_extent(path),
+        }
+    return json.dumps(extents, indent='\t') + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='fail if the generated file is out of date instead of writing it')
+    args = parser.parse_args()
+
+    generated = generate()
+    if args.check:
+        existing = open(OUTPUT_PATH).read() if os.path.exists(OUTPUT_PATH) else ''
+        if existing != generated:
+            sys.exit(os.path.relpath(OUTPUT_PATH, PROJECT_DIR) + ' is out of date, run ' + os.path.basename(__file__))
+        return
+
+    with open(OUTPUT_PATH, 'w') as f:
+        f.write(generated)
+    print('Wrote ' + os.path.relpath(OUTPUT_PATH, PROJECT_DIR))
+
+
+if __name__ == '__main__':
+    main()
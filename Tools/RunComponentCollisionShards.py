@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""Runs the ComponentCollision automation specs in parallel headless editor processes on one Linux machine.
+
+The tests are listed by one editor run, split into shards by their recorded durations (slowest first, each test
+going to the least loaded shard), and every shard runs in its own `-nullrhi` editor, started with
+`-ComponentCollisionShard=<file>` so the module queues the tests of the shard itself. The reports of the shards
+are merged into one index.json, the per-shard sweep benchmark reports into Saved/Automation/Benchmarks, and the
+measured durations are written back to Benchmarks/ComponentCollisionTestTimings.json for the next run.
+
+The benchmarks and the memory report (the PerfFilter specs) take far longer than the rest of the suite, so they
+only run with --benchmarks.
+
+    Tools/RunComponentCollisionShards.py --shards 4 [--editor path/to/UE4Editor-Cmd] [--filter ComponentCollision] [--benchmarks]
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+TIMINGS_PATH = os.path.join(PROJECT_DIR, 'Benchmarks', 'ComponentCollisionTestTimings.json')
+OUTPUT_DIR = os.path.join(PROJECT_DIR, 'Saved', 'Automation', 'Shards')
+BENCHMARK_REPORT_PATH = os.path.join(PROJECT_DIR, 'Saved', 'Automation', 'Benchmarks', 'ComponentSweep.json')
+# The test paths of the PerfFilter specs, which the automation list doesn't flag
+PERF_TEST_PREFIXES = ('ComponentCollision.Benchmarks.', 'ComponentCollision.SharedBodyShapes.')
+# ComponentCollisionTestFixture reports the setup and sweep time of every test in this form
+FIXTURE_TIME_RE = re.compile(r'^Setup ([0-9.]+) ms, sweeps ([0-9.]+) ms')
+
+
+def find_project_file():
+    for name in os.listdir(PROJECT_DIR):
+        if name.endswith('.uproject'):
+            return os.path.join(PROJECT_DIR, name)
+    sys.exit('No .uproject found in ' + PROJECT_DIR)
+
+
+def find_editor(project_file):
+    with open(project_file) as f:
+        engine_association = json.load(f).get('EngineAssociation', '')
+    engine_dir = os.path.normpath(os.path.join(PROJECT_DIR, engine_association))
+    return os.path.join(engine_dir, 'Engine', 'Binaries', 'Linux', 'UE4Editor-Cmd')
+
+
+def editor_command(editor, project_file, log_path, extra_args):
+    return [editor, project_file, '-unattended', '-nullrhi', '-nosound', '-nosplash', '-nopause', '-stdout',
+            '-FullStdOutLogOutput', '-abslog=' + log_path] + extra_args
+
+
+def list_tests(editor, project_file, test_filter, benchmarks):
+    log_path = os.path.join(OUTPUT_DIR, 'list.log')
+    output = subprocess.run(editor_command(editor, project_file, log_path, ['-ExecCmds=Automation List;Quit']),
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True).stdout
+    tests = set()
+    for line in output.splitlines():
+        match = re.search(r'LogAutomationCommandLine: Display: \s*(.+?)\s*$', line)
+        if match and match.group(1).startswith(test_filter):
+            if benchmarks or not match.group(1).startswith(PERF_TEST_PREFIXES):
+                tests.add(match.group(1))
+    return sorted(tests)
+
+
+def group_by_prefix(tests):
+    """RunTests matches by prefix, so a test whose path starts with another one's must run in the same shard."""
+    groups = []
+    for test in sorted(tests):
+        if groups and test.startswith(groups[-1][0]):
+            groups[-1].append(test)
+        else:
+            groups.append([test])
+    return groups
+
+
+def load_timings():
+    try:
+        with open(TIMINGS_PATH) as f:
+            return json.load(f).get('Tests', {})
+    except (OSError, ValueError):
+        return {}
+
+
+def assign_shards(groups, timings, num_shards):
+    """Longest processing time first: slowest groups first, each to the shard with the least recorded time."""
+    known = [seconds for seconds in timings.values()]
+    default_seconds = max(known) if known else 1.0
+
+    def group_seconds(group):
+        return sum(timings.get(test, default_seconds) for test in group)
+
+    shards = [{'tests': [], 'seconds': 0.0} for _ in range(num_shards)]
+    for group in sorted(groups, key=group_seconds, reverse=True):
+        shard = min(shards, key=lambda s: s['seconds'])
+        shard['tests'].extend(group)
+        shard['seconds'] += group_seconds(group)
+    return [shard for shard in shards if shard['tests']]
+
+
+def start_shard(index, shard, editor, project_file):
+    shard_dir = os.path.join(OUTPUT_DIR, 'Shard%d' % index)
+    os.makedirs(shard_dir, exist_ok=True)
+    shard_file = os.path.join(shard_dir, 'Tests.txt')
+    with open(shard_file, 'w') as f:
+        f.write('\n'.join(shard['tests']) + '\n')
+
+    args = ['-ComponentCollisionShard=' + shard_file,
+            '-ReportExportPath=' + os.path.join(shard_dir, 'Report'),
+            '-SweepBenchmarkReport=' + os.path.join(shard_dir, 'ComponentSweep.json')]
+    log = open(os.path.join(shard_dir, 'Editor.log.stdout'), 'w')
+    process = subprocess.Popen(editor_command(editor, project_file, os.path.join(shard_dir, 'Editor.log'), args),
+                               stdout=log, stderr=subprocess.STDOUT)
+    print('Shard %d: %d tests, %.1f s expected' % (index, len(shard['tests']), shard['seconds']))
+    return {'index': index, 'dir': shard_dir, 'process': process, 'log': log, 'start': time.time()}
+
+
+def load_json(path):
+    try:
+        with open(path, encoding='utf-8-sig') as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+
+def measured_seconds(test):
+    if test.get('duration'):
+        return float(test['duration'])
+    for entry in test.get('entries', []):
+        match = FIXTURE_TIME_RE.match(entry.get('event', {}).get('message', ''))
+        if match:
+            return (float(match.group(1)) + float(match.group(2))) / 1000.0
+    return None
+
+
+def merge_reports(running, timings):
+    merged = {'shards': [], 'succeeded': 0, 'succeededWithWarnings': 0, 'failed': 0, 'notRun': 0,
+              'totalDuration': 0.0, 'tests': []}
+    seen = set()
+    for shard in running:
+        report = load_json(os.path.join(shard['dir'], 'Report', 'index.json'))
+        merged['shards'].append({'index': shard['index'], 'exitCode': shard['process'].returncode,
+                                 'wallSeconds': shard['seconds'], 'reported': report is not None})
+        if report is None:
+            continue
+        for key in ('succeeded', 'succeededWithWarnings', 'failed', 'notRun'):
+            merged[key] += report.get(key, 0)
+        merged['totalDuration'] = max(merged['totalDuration'], report.get('totalDuration', 0.0))
+        for test in report.get('tests', []):
+            path = test.get('fullTestPath')
+            if path in seen:
+                continue
+            seen.add(path)
+            merged['tests'].append(test)
+            seconds = measured_seconds(test)
+            if seconds is not None:
+                timings[path] = round(seconds, 3)
+    return merged
+
+
+def merge_benchmark_reports(running):
+    variants = {}
+    for shard in running:
+        report = load_json(os.path.join(shard['dir'], 'ComponentSweep.json'))
+        if report:
+            variants.update(report.get('Variants', {}))
+    if not variants:
+        return
+    report = load_json(BENCHMARK_REPORT_PATH) or {}
+    report.setdefault('Variants', {}).update(variants)
+    os.makedirs(os.path.dirname(BENCHMARK_REPORT_PATH), exist_ok=True)
+    with open(BENCHMARK_REPORT_PATH, 'w') as f:
+        json.dump(report, f, indent='\t')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--shards', type=int, default=max(1, min(4, (os.cpu_count() or 2) // 2)))
+    parser.add_argument('--editor', help='UE4Editor-Cmd to run; defaults to the one of EngineAssociation')
+    parser.add_argument('--filter', default='ComponentCollision', help='prefix of the test paths to run')
+    parser.add_argument('--benchmarks', action='store_true', help='also run the PerfFilter specs: ' + ', '.join(PERF_TEST_PREFIXES))
+    args = parser.parse_args()
+
+    project_file = find_project_file()
+    editor = args.editor or find_editor(project_file)
+    os.makedirs(OUTPUT_DIR, exist_ok=True)
+
+    tests = list_tests(editor, project_file, args.filter, args.benchmarks)
+    if not tests:
+        sys.exit('No tests matching %s; see %s' % (args.filter, os.path.join(OUTPUT_DIR, 'list.log')))
+
+    timings = load_timings()
+    shards = assign_shards(group_by_prefix(tests), timings, args.shards)
+    running = [start_shard(index, shard, editor, project_file) for index, shard in enumerate(shards)]
+    for shard in running:
+        shard['process'].wait()
+        shard['log'].close()
+        shard['seconds'] = round(time.time() - shard['start'], 1)
+        print('Shard %d finished in %.1f s with exit code %d' % (shard['index'], shard['seconds'], shard['process'].returncode))
+
+    merged = merge_reports(running, timings)
+    with open(os.path.join(OUTPUT_DIR, 'index.json'), 'w') as f:
+        json.dump(merged, f, indent='\t')
+    with open(TIMINGS_PATH, 'w') as f:
+        json.dump({'Tests': dict(sorted(timings.items()))}, f, indent='\t')
+        f.write('\n')
+    merge_benchmark_reports(running)
+
+    missing = set(tests) - set(test.get('fullTestPath') for test in merged['tests'])
+    print('%d succeeded, %d with warnings, %d failed, %d not reported' %
+          (merged['succeeded'], merged['succeededWithWarnings'], merged['failed'], len(missing)))
+    for test in merged['tests']:
+        if test.get('state') == 'Fail':
+            print('FAILED: ' + test.get('fullTestPath'))
+    for path in sorted(missing):
+        print('NOT REPORTED: ' + path)
+
+    failed = merged['failed'] > 0 or missing or any(shard['process'].returncode != 0 for shard in running)
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())